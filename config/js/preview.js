@@ -34,6 +34,7 @@ var GraphitePreview = (function () {
     var tnow = time(NULL);
     var weather;
     var phonebat;
+    var phonebat_disconnected = 0;
     var buffer_1, buffer_2, buffer_3, buffer_4;
     var font_main = 'Open Sans Condensed';
     var font_weather = 'nupe2';
@@ -44,6 +45,7 @@ var GraphitePreview = (function () {
     var height, width, height_full, width_full;
     var rem_is_pix = false;
     var show_secondary_widgets = false;
+    var power_saver = false;
 
 // -- autogen
 // -- ## for key in configuration
@@ -118,6 +120,13 @@ var GraphitePreview = (function () {
      var config_phone_battery_expiration;
      var config_phone_battery_refresh;
      var config_update_phonebat_on_shake;
+     var config_phone_battery_push;
+     var config_phone_battery_hysteresis_local;
+     var config_weather_fallback_source_local;
+     var config_weather_fallback_apikey_local;
+     var config_prerender_next_minute;
+     var config_power_saver;
+     var config_ambient;
 // -- end autogen
 
     function get(k) {
@@ -163,6 +172,10 @@ var GraphitePreview = (function () {
     var PBL_DISPLAY_HEIGHT;
     var IF_HR;
     var GRAPHITE_UNKNOWN_WEATHER = 32767;
+    var GRAPHITE_NOWCAST_MINUTES = 60;
+    var GRAPHITE_NOWCAST_MAX_LEVEL = 15;
+    function nowcast_available() { return false; }
+    function nowcast_level(minute) { return 0; }
 
     // graphics functions and constants
     function GPoint(x, y) { return {x: x, y: y}; }
@@ -180,6 +193,73 @@ var GraphitePreview = (function () {
     function PIX(x) { return INT_TO_FIXED(x); }
     function FIXED_TO_INT(x) { return Math.floor(x/FIXED_POINT_SCALE); }
     function FIXED_ROUND(x) { return ((x) % FIXED_POINT_SCALE < FIXED_POINT_SCALE/2 ? (x) - ((x) % FIXED_POINT_SCALE) : (x) + FIXED_POINT_SCALE - ((x) % FIXED_POINT_SCALE)) }
+    // layout constants (see layout in scripts/initialize.py), these depend on the platform and rem_is_pix
+// -- autogen
+// -- ## for l in layout
+// --     var {{ l.name }};
+// -- ## endfor
+    var LAYOUT_POPUP_HEIGHT;
+    var LAYOUT_POPUP_ICON_WIDTH;
+    var LAYOUT_POPUP_FONTSIZE;
+    var LAYOUT_POPUP_LINE_1_Y;
+    var LAYOUT_POPUP_LINE_2_Y;
+    var LAYOUT_POPUP_ICON_X;
+    var LAYOUT_POPUP_ICON_Y;
+    var LAYOUT_POPUP_ICON_FONTSIZE;
+    var LAYOUT_FONTSIZE_BORDER;
+    var LAYOUT_FONTSIZE_MIN;
+    var LAYOUT_FONTSIZE_DATE;
+    var LAYOUT_TOPBAR_HEIGHT;
+    var LAYOUT_NOWCAST_HEIGHT;
+    var LAYOUT_RAIN_INDICATOR_HEIGHT;
+    var LAYOUT_RAIN_BAR_SEP;
+    var LAYOUT_RAIN_BAR_MAXHEIGHT;
+    var LAYOUT_PROGRESS_HEIGHT;
+    var LAYOUT_PROGRESS_OVERLAP;
+    var LAYOUT_FONTSIZE_WIDGETS;
+    var LAYOUT_WIDGETS_MARGIN_TOPBOTTOM;
+    var LAYOUT_WIDGETS_MARGIN_LEFTRIGHT;
+    var LAYOUT_WIDGETS_BOTTOM_PADDING;
+    var LAYOUT_WIDGET_SEP;
+    var LAYOUT_ICON_OFFSET;
+    var LAYOUT_BAT_CENTER;
+    var LAYOUT_STATUS_ICON_FONTSIZE;
+    var LAYOUT_STATUS_ICON_Y;
+// -- end autogen
+    function update_layout() {
+// -- autogen
+// -- ## for l in layout
+// --         {{ l.name }} = {{ l.preview_expr }};
+// -- ## endfor
+        LAYOUT_POPUP_HEIGHT = FIXED_ROUND(REM(60));
+        LAYOUT_POPUP_ICON_WIDTH = REM(40);
+        LAYOUT_POPUP_FONTSIZE = REM(23);
+        LAYOUT_POPUP_LINE_1_Y = REM(7);
+        LAYOUT_POPUP_LINE_2_Y = REM(35);
+        LAYOUT_POPUP_ICON_X = REM(20);
+        LAYOUT_POPUP_ICON_Y = REM(30);
+        LAYOUT_POPUP_ICON_FONTSIZE = REM(30);
+        LAYOUT_FONTSIZE_BORDER = REM(20);
+        LAYOUT_FONTSIZE_MIN = REM(15);
+        LAYOUT_FONTSIZE_DATE = REM(28);
+        LAYOUT_TOPBAR_HEIGHT = FIXED_ROUND(REM(27) + REM(4));
+        LAYOUT_NOWCAST_HEIGHT = FIXED_ROUND(REM(6));
+        LAYOUT_RAIN_INDICATOR_HEIGHT = FIXED_ROUND(REM(3));
+        LAYOUT_RAIN_BAR_SEP = REM(2);
+        LAYOUT_RAIN_BAR_MAXHEIGHT = REM(20);
+        LAYOUT_PROGRESS_HEIGHT = REM(5);
+        LAYOUT_PROGRESS_OVERLAP = REM(1);
+        LAYOUT_FONTSIZE_WIDGETS = REM(27);
+        LAYOUT_WIDGETS_MARGIN_TOPBOTTOM = REM(6);
+        LAYOUT_WIDGETS_MARGIN_LEFTRIGHT = REM(8);
+        LAYOUT_WIDGETS_BOTTOM_PADDING = REM(2);
+        LAYOUT_WIDGET_SEP = REM(2);
+        LAYOUT_ICON_OFFSET = REM(7);
+        LAYOUT_BAT_CENTER = REM(21);
+        LAYOUT_STATUS_ICON_FONTSIZE = REM(25);
+        LAYOUT_STATUS_ICON_Y = REM(11);
+// -- end autogen
+    }
     function fctx_init_context() {}
     function fctx_deinit_context() {}
     function layer_get_unobstructed_bounds() { return layer_get_bounds(); }
@@ -187,6 +267,9 @@ var GraphitePreview = (function () {
     function time() {
       return get('time')
     }
+    function frame_time() {
+      return time();
+    }
     function localtime(t) {
         return new Date(t * 1000);
     }
@@ -294,6 +377,7 @@ var GraphitePreview = (function () {
         PBL_DISPLAY_WIDTH = PebbleHelper.PBL_DISPLAY_WIDTH(platform);
         PBL_DISPLAY_HEIGHT = PebbleHelper.PBL_DISPLAY_HEIGHT(platform);
         IF_HR = PebbleHelper.IF_HR(platform);
+        update_layout();
 
 // -- autogen
 // -- ## for key in configuration
@@ -368,6 +452,13 @@ var GraphitePreview = (function () {
         config_phone_battery_expiration = config["CONFIG_PHONE_BATTERY_EXPIRATION"];
         config_phone_battery_refresh = config["CONFIG_PHONE_BATTERY_REFRESH"];
         config_update_phonebat_on_shake = config["CONFIG_UPDATE_PHONEBAT_ON_SHAKE"];
+        config_phone_battery_push = config["CONFIG_PHONE_BATTERY_PUSH"];
+        config_phone_battery_hysteresis_local = config["CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL"];
+        config_weather_fallback_source_local = config["CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL"];
+        config_weather_fallback_apikey_local = config["CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL"];
+        config_prerender_next_minute = config["CONFIG_PRERENDER_NEXT_MINUTE"];
+        config_power_saver = config["CONFIG_POWER_SAVER"];
+        config_ambient = config["CONFIG_AMBIENT"];
 // -- end autogen
 
         weather = getWeather(platform);
@@ -385,10 +476,7 @@ var GraphitePreview = (function () {
         var h = 30;
         var sep = REM(5);
         var fctx;
-// -- autogen
-// --         fontsize_widgets = REM({{ fontsize_widgets }});
-        fontsize_widgets = REM(27);
-// -- end autogen
+        fontsize_widgets = LAYOUT_FONTSIZE_WIDGETS;
 
         canvas.height = h;
         canvas.width = w;
@@ -488,7 +576,7 @@ function draw_icon_number_widget(fctx, draw, position, align, foreground_color,
   var fontsize_icon = (fontsize_widgets * 31 / 50); // 0.62
   var w1 = !show_icon ? 0 : string_width(fctx, icon, font_icon, fontsize_icon);
   var w2 = string_width(fctx, text, font_main, fontsize_widgets);
-  var sep = REM(2);
+  var sep = LAYOUT_WIDGET_SEP;
   var w = w1 + w2 + sep;
   var a = GTextAlignmentLeft;
   var color = foreground_color;
@@ -569,7 +657,7 @@ function drawBat(fctx, draw, position, align, foreground_color, background_color
     if (align == GTextAlignmentCenter) offset = bat_width / 2;
     if (align == GTextAlignmentRight) offset = bat_width;
     var bat_origin = FPoint(FIXED_ROUND(position.x - offset), FIXED_ROUND(
-            position.y + (REM(21) - bat_height) / 2));
+            position.y + (LAYOUT_BAT_CENTER - bat_height) / 2));
     draw_rect(fctx, FRect(bat_origin, FSize(bat_width, bat_height)), foreground_color);
     draw_rect(fctx, FRect(FPoint(bat_origin.x + bat_thickness, bat_origin.y + bat_thickness), FSize(bat_width - 2*bat_thickness, bat_height - 2*bat_thickness)), background_color);
     draw_rect(fctx, FRect(FPoint(bat_origin.x + bat_thickness + bat_gap_thickness, bat_origin.y + bat_thickness + bat_gap_thickness + (100 - level) * bat_inner_height / 100), FSize(
@@ -587,7 +675,12 @@ function widget_battery_icon(fctx, draw, position, align, foreground_color, back
     return drawBat(fctx, draw, position, align, foreground_color, background_color, battery_state_service_peek().charge_percent);
 }
 function showPhoneBattery() {
-    var battery_is_outdated = (time(NULL) - phonebat.timestamp) > (config_phone_battery_expiration * 60);
+    var last_contact = phonebat.timestamp;
+    var expiration = config_phone_battery_expiration * 60;
+    if (config_phone_battery_push && phonebat_disconnected > last_contact && phonebat_disconnected - last_contact <= expiration) {
+        last_contact = phonebat_disconnected;
+    }
+    var battery_is_outdated = (frame_time() - last_contact) > expiration;
     var invalid_bat_level = phonebat.level > 100;
     return !battery_is_outdated && !invalid_bat_level;
 }
@@ -645,62 +738,62 @@ function widget_both_battery_flipped_icon(fctx, draw, position, align, foregroun
 }
 function widget_bluetooth_disconly(fctx, draw, position, align, foreground_color, background_color) {
   if (!bluetooth_connection_service_peek()) {
-    var fontsize_bt_icon = REM(25);
-    if (draw) draw_string(fctx, "H", FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+    var fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
+    if (draw) draw_string(fctx, "H", FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
     return string_width(fctx, "H", font_icon, fontsize_widgets);
   }
   return 0;
 }
 function widget_bluetooth_disconly_alt(fctx, draw, position, align, foreground_color, background_color) {
   if (!bluetooth_connection_service_peek()) {
-    var fontsize_bt_icon = REM(25);
-    if (draw) draw_string(fctx, "I", FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+    var fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
+    if (draw) draw_string(fctx, "I", FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
     return string_width(fctx, "I", font_icon, fontsize_widgets);
   }
   return 0;
 }
 function widget_bluetooth_yesno(fctx, draw, position, align, foreground_color, background_color) {
-  var fontsize_bt_icon = REM(25);
+  var fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
   var icon = "DH";
   if (!bluetooth_connection_service_peek()) {
     icon = "BH";
   }
-  if (draw) draw_string(fctx, icon, FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+  if (draw) draw_string(fctx, icon, FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
   return string_width(fctx, icon, font_icon, fontsize_bt_icon);
 }
 function widget_quiet_offonly(fctx, draw, position, align, foreground_color, background_color) {
   if (quiet_time_is_active()) {
-    var fontsize_bt_icon = REM(25);
-    if (draw) draw_string(fctx, "F", FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+    var fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
+    if (draw) draw_string(fctx, "F", FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
     return string_width(fctx, "F", font_icon, fontsize_bt_icon);
   }
   return 0;
 }
 function widget_quiet(fctx, draw, position, align, foreground_color, background_color) {
-  var fontsize_bt_icon = REM(25);
+  var fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
   var icon = "G";
   if (quiet_time_is_active()) {
     icon = "F";
   }
-  if (draw) draw_string(fctx, icon, FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+  if (draw) draw_string(fctx, icon, FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
   return string_width(fctx, icon, font_icon, fontsize_bt_icon);
 }
 function widget_ampm(fctx, draw, position, align, foreground_color, background_color) {
-  var now = time(NULL);
+  var now = frame_time();
     var t = localtime(now);
   buffer_1 = strftime("%p", t);
   if (draw) draw_string(fctx, buffer_1, position, font_main, foreground_color, fontsize_widgets, align);
   return string_width(fctx, buffer_1, font_main, fontsize_widgets);
 }
 function widget_ampm_lower(fctx, draw, position, align, foreground_color, background_color) {
-  var now = time(NULL);
+  var now = frame_time();
     var t = localtime(now);
   buffer_1 = strftime("%P", t);
   if (draw) draw_string(fctx, buffer_1, position, font_main, foreground_color, fontsize_widgets, align);
   return string_width(fctx, buffer_1, font_main, fontsize_widgets);
 }
 function widget_seconds(fctx, draw, position, align, foreground_color, background_color) {
-  var now = time(NULL);
+  var now = frame_time();
     var t = localtime(now);
   buffer_1 = strftime("%S", t);
   buffer_1 = 
@@ -709,7 +802,7 @@ function widget_seconds(fctx, draw, position, align, foreground_color, backgroun
   return string_width(fctx, buffer_1, font_main, fontsize_widgets);
 }
 function widget_day_of_week(fctx, draw, position, align, foreground_color, background_color) {
-  var now = time(NULL);
+  var now = frame_time();
   var t = localtime(now);
   buffer_1 = strftime("%a", t);
   if (draw) draw_string(fctx, buffer_1, position, font_main, foreground_color, fontsize_widgets, align);
@@ -847,21 +940,27 @@ function is_obstructed() {
     var partial = layer_get_unobstructed_bounds(layer);
     return full.size.h != partial.size.h || full.size.w != partial.size.w;
 }
+/**
+ * How far the time and date are moved up when the bottom of the screen is obstructed (e.g., by a timeline peek).
+ */
+function time_offset(full_height, unobstructed_height) {
+    return PBL_DISPLAY_WIDTH != 144 ? 0 : (full_height - unobstructed_height) / 8;
+}
 /**
  * Draws a popup about the bluetooth connection
  */
 function bluetooth_popup(fctx, ctx, connected) {
     if (!show_bluetooth_popup) return;
-    var h = FIXED_ROUND(REM(60));
-    var rh_size = REM(40);
+    var h = LAYOUT_POPUP_HEIGHT;
+    var rh_size = LAYOUT_POPUP_ICON_WIDTH;
     draw_rect(fctx, FRect(FPoint(0, 0), FSize(width, h + PIX(2))), GColor.Black);
     draw_rect(fctx, FRect(FPoint(0, 0), FSize(width, h)), GColor.White);
     draw_rect(fctx, FRect(FPoint(width-rh_size, 0), FSize(rh_size, h)), GColor.VividCerulean);
-    var fs = REM(23);
+    var fs = LAYOUT_POPUP_FONTSIZE;
     var str2 = connected ? "Connected" : "Disconnected";
-    draw_string(fctx, "Bluetooth", FPoint((width - rh_size)/2, REM(7)), font_main, GColor.Black, fs, GTextAlignmentCenter);
-    draw_string(fctx, str2, FPoint((width - rh_size)/2, REM(35)), font_main, GColor.Black, fs, GTextAlignmentCenter);
-    draw_string(fctx, connected ? "D" : "B", FPoint(width - REM(20), REM(30)), font_icon, GColor.Black, REM(30), GTextAlignmentCenter);
+    draw_string(fctx, "Bluetooth", FPoint((width - rh_size)/2, LAYOUT_POPUP_LINE_1_Y), font_main, GColor.Black, fs, GTextAlignmentCenter);
+    draw_string(fctx, str2, FPoint((width - rh_size)/2, LAYOUT_POPUP_LINE_2_Y), font_main, GColor.Black, fs, GTextAlignmentCenter);
+    draw_string(fctx, connected ? "D" : "B", FPoint(width - LAYOUT_POPUP_ICON_X, LAYOUT_POPUP_ICON_Y), font_icon, GColor.Black, LAYOUT_POPUP_ICON_FONTSIZE, GTextAlignmentCenter);
 }
 /**
  * Remove all leading zeros in a string.
@@ -875,7 +974,7 @@ function draw_weather(fctx, draw, icon, temp, position, color, fontsize, align,
     var weather_fontsize = (fontsize * 23 / 20); // 1.15
     var w1 = string_width(fctx, icon, font_weather, weather_fontsize);
     var w2 = string_width(fctx, temp, font_main, fontsize);
-    var sep = w1 == 0 || w2 == 0 ? REM(0) : REM(2);
+    var sep = w1 == 0 || w2 == 0 ? 0 : LAYOUT_WIDGET_SEP;
     var w = w1 + w2 + sep;
     var a = GTextAlignmentLeft;
     var offset1 = flip_order ? w2 + sep : 0;
@@ -902,14 +1001,14 @@ function show_weather() {
 function show_weather_impl(timeout) {
     var weather_is_on = config_weather_refresh > 0;
     var weather_is_available = weather.timestamp > 0;
-    var weather_is_outdated = (time(NULL) - weather.timestamp) > (timeout * 60);
+    var weather_is_outdated = (frame_time() - weather.timestamp) > (timeout * 60);
     var show_weather = weather_is_on && weather_is_available && !weather_is_outdated;
     return show_weather;
 }
 function find_fontsize(fctx, target, min, str) {
     var l = min;
     var h = target;
-    var border = REM(20);
+    var border = LAYOUT_FONTSIZE_BORDER;
     if (string_width(fctx, str, font_main, target) <= width - border) {
         return target;
     }
@@ -923,6 +1022,19 @@ function find_fontsize(fctx, target, min, str) {
     }
     return l;
 }
+/**
+ * Draw a set of widgets: three in the top bar, and three at the bottom (at height bottom_y).
+ */
+function draw_widget_rows(fctx, w1, w2, w3, w4, w5, w6, bottom_y, topbar_color) {
+    var widgets_margin_topbottom = LAYOUT_WIDGETS_MARGIN_TOPBOTTOM; // gap between watch bounds and widgets
+    var widgets_margin_leftright = LAYOUT_WIDGETS_MARGIN_LEFTRIGHT;
+    widgets[w1](fctx, true, FPoint(widgets_margin_leftright, widgets_margin_topbottom), GTextAlignmentLeft, config_color_widget_1, topbar_color);
+    widgets[w2](fctx, true, FPoint(width / 2, widgets_margin_topbottom), GTextAlignmentCenter, config_color_widget_2, topbar_color);
+    widgets[w3](fctx, true, FPoint(width - widgets_margin_leftright, widgets_margin_topbottom), GTextAlignmentRight, config_color_widget_3, topbar_color);
+    widgets[w4](fctx, true, FPoint(widgets_margin_leftright, bottom_y), GTextAlignmentLeft, config_color_widget_4, config_color_background);
+    widgets[w5](fctx, true, FPoint(width / 2, bottom_y), GTextAlignmentCenter, config_color_widget_5, config_color_background);
+    widgets[w6](fctx, true, FPoint(width - widgets_margin_leftright, bottom_y), GTextAlignmentRight, config_color_widget_6, config_color_background);
+}
 /**
  * Draw the watch face.
  */
@@ -935,8 +1047,8 @@ function background_update_proc(layer, ctx) {
     width = bounds.size.w;
     var bounds_full = g2frect(layer_get_bounds(layer_background));
     height_full = bounds_full.size.h;
-    fontsize_widgets = REM(27);
-    var now = time(NULL);
+    fontsize_widgets = LAYOUT_FONTSIZE_WIDGETS;
+    var now = frame_time();
     var t = localtime(now);
     var battery_state = battery_state_service_peek();
     if (battery_state.is_charging || battery_state.is_plugged) {
@@ -961,13 +1073,26 @@ function background_update_proc(layer, ctx) {
           config_color_progress_bar_local = override_col;
     }
     draw_rect(fctx, bounds_full, config_color_background);
-    var fontsize_weather = fontsize_widgets;
-    var topbar_height = FIXED_ROUND(fontsize_weather + REM(4));
-    draw_rect(fctx, FRect(bounds.origin, FSize(width, topbar_height)), config_color_topbar_bg_local);
-    if (show_weather()) {
+    var topbar_height = LAYOUT_TOPBAR_HEIGHT;
+    var frozen = false;
+    if (!frozen) draw_rect(fctx, FRect(bounds.origin, FSize(width, topbar_height)), config_color_topbar_bg_local);
+    var chart_bottom = topbar_height;
+    if (show_weather() && !power_saver && !frozen) {
+        var nowcast_h = nowcast_available() ? LAYOUT_NOWCAST_HEIGHT : 0;
+        if (nowcast_h != 0) {
+            for(var i = 0; i < GRAPHITE_NOWCAST_MINUTES; i++) {
+                var level = nowcast_level(i);
+                if (level == 0) continue;
+                var x = width * i / GRAPHITE_NOWCAST_MINUTES;
+                var w = width * (i + 1) / GRAPHITE_NOWCAST_MINUTES - x;
+                var size = FSize(w, nowcast_h * level / GRAPHITE_NOWCAST_MAX_LEVEL);
+                draw_rect(fctx, FRect(FPoint(x, topbar_height), size), config_color_perc);
+            }
+        }
+        chart_bottom = topbar_height + nowcast_h;
         var first_perc_index = -1;
         var sec_in_hour = 60*60;
-        var cur_h_ts = time(NULL);
+        var cur_h_ts = frame_time();
         cur_h_ts -= cur_h_ts % sec_in_hour; // align with hour
         for(var i = 0; i < weather.perc_data_len; i++) {
             if (cur_h_ts == weather.perc_data_ts + i * sec_in_hour) {
@@ -989,44 +1114,47 @@ function background_update_proc(layer, ctx) {
         }
     first_perc_index = 0;
         if (first_perc_index != -1 && !all_zero) {
-            var perc_ti_h = config_show_daynight ? FIXED_ROUND(REM(3)) : 0;
-            var perc_sep = REM(2); // space between two bars
+            var perc_ti_h = config_show_daynight ? LAYOUT_RAIN_INDICATOR_HEIGHT : 0;
+            var perc_sep = LAYOUT_RAIN_BAR_SEP; // space between two bars
             var perc_bar = (width - (nHours + 1) * perc_sep) / nHours; // width of a single bar (without space)
             var perc_w = perc_sep + perc_bar; // total width occupied by a single hour
-            var perc_maxheight = REM(20); // max height of the precipitation bar
+            var perc_maxheight = LAYOUT_RAIN_BAR_MAXHEIGHT; // max height of the precipitation bar
             var perc_minoffset = - perc_w * (t.tm_min % 60) / 60; // x axis offset into the current hour
+            chart_bottom = topbar_height + nowcast_h + perc_ti_h + perc_maxheight;
             for(var i = 0; i < nHours + 1; i++) {
                 var i_percip_prob = 0;
                 if (first_perc_index + i < weather.perc_data_len) {
                     i_percip_prob = weather.perc_data[first_perc_index + i];
                 }
-                var point = FPoint(perc_minoffset + perc_sep / 2 + i * perc_w, topbar_height + perc_ti_h);
+                var point = FPoint(perc_minoffset + perc_sep / 2 + i * perc_w, topbar_height + nowcast_h + perc_ti_h);
                 var size = FSize(perc_bar, perc_maxheight * i_percip_prob / 100);
                 draw_rect(fctx, FRect(point, size), config_color_perc);
             }
             if (config_show_daynight) {
-                draw_rect(fctx, FRect(FPoint(0, topbar_height), FSize(width, perc_ti_h)), config_color_day);
+                draw_rect(fctx, FRect(FPoint(0, topbar_height + nowcast_h), FSize(width, perc_ti_h)), config_color_day);
                 for(var i = -1; i < 2; i++) {
-                    var point = FPoint(perc_minoffset + (24*i + 18 - t.tm_hour) * perc_w, topbar_height);
+                    var point = FPoint(perc_minoffset + (24*i + 18 - t.tm_hour) * perc_w, topbar_height + nowcast_h);
                     draw_rect(fctx, FRect(point, FSize(12 * perc_w, perc_ti_h)), config_color_night);
                 }
             }
         }
     }
-    var time_y_offset = PBL_DISPLAY_WIDTH != 144 ? 0 : (height_full-height) / 8;
+    var time_y_offset = time_offset(height_full, height);
     setlocale(LC_ALL, "");
     buffer_1 = strftime(config_time_format, t);
     buffer_1 = 
     remove_leading_zero(buffer_1, sizeof(buffer_1));
     var fontsize_time = (width * 9/20); // 1/2.2
-    var fontsize_time_real = find_fontsize(fctx, fontsize_time, REM(15), buffer_1);
-    draw_string(fctx, buffer_1, FPoint(width / 2, height_full / 2 - fontsize_time_real / 2 - time_y_offset), font_main, config_color_time, fontsize_time_real, GTextAlignmentCenter);
+    var fontsize_time_real = find_fontsize(fctx, fontsize_time, LAYOUT_FONTSIZE_MIN, buffer_1);
+    var time_y = height_full / 2 - fontsize_time_real / 2 - time_y_offset;
+    draw_string(fctx, buffer_1, FPoint(width / 2, time_y), font_main, config_color_time, fontsize_time_real, GTextAlignmentCenter);
     buffer_1 = strftime(config_info_below, t);
     buffer_1 = 
     remove_leading_zero(buffer_1, sizeof(buffer_1));
-    var fontsize_date = REM(28);
-    var fontsize_date_real = find_fontsize(fctx, fontsize_date, REM(15), buffer_1);
-    draw_string(fctx, buffer_1, FPoint(width / 2, height_full / 2 + fontsize_time / 3 - time_y_offset), font_main, config_color_info_below_local, fontsize_date_real, GTextAlignmentCenter);
+    var fontsize_date = LAYOUT_FONTSIZE_DATE;
+    var fontsize_date_real = find_fontsize(fctx, fontsize_date, LAYOUT_FONTSIZE_MIN, buffer_1);
+    var date_y = height_full / 2 + fontsize_time / 3 - time_y_offset;
+    draw_string(fctx, buffer_1, FPoint(width / 2, date_y), font_main, config_color_info_below_local, fontsize_date_real, GTextAlignmentCenter);
     var progress_cur = 0;
     var progress_max = 0;
     var progress_no = config_progress == 0;
@@ -1038,7 +1166,7 @@ function background_update_proc(layer, ctx) {
         progress_max = 100;
     }
     if (progress_max == 0) progress_max = 1;
-    var progress_height = REM(5);
+    var progress_height = LAYOUT_PROGRESS_HEIGHT;
     var progress_endx = width * progress_cur / progress_max;
     if (!progress_no) {
         draw_rect(fctx, FRect(FPoint(0, height_full - progress_height), FSize(progress_endx, progress_height)), config_color_progress_bar_local);
@@ -1049,13 +1177,14 @@ function background_update_proc(layer, ctx) {
             draw_circle(fctx, FPoint(progress_endx2, height_full), progress_height, config_color_progress_bar2);
         }
     }
+    var secondary = show_secondary_widgets && config_2nd_widgets;
     var w1 = config_widget_1;
     var w2 = config_widget_2;
     var w3 = config_widget_3;
     var w4 = config_widget_4;
     var w5 = config_widget_5;
     var w6 = config_widget_6;
-    if (show_secondary_widgets && config_2nd_widgets) {
+    if (secondary) {
         w1 = config_widget_7;
         w2 = config_widget_8;
         w3 = config_widget_9;
@@ -1063,16 +1192,10 @@ function background_update_proc(layer, ctx) {
         w5 = config_widget_11;
         w6 = config_widget_12;
     }
-    var widgets_margin_topbottom = REM(6); // gap between watch bounds and widgets
-    var widgets_margin_leftright = REM(8);
-    widgets[w1](fctx, true, FPoint(widgets_margin_leftright, widgets_margin_topbottom), GTextAlignmentLeft, config_color_widget_1, config_color_topbar_bg_local);
-    widgets[w2](fctx, true, FPoint(width / 2, widgets_margin_topbottom), GTextAlignmentCenter, config_color_widget_2, config_color_topbar_bg_local);
-    widgets[w3](fctx, true, FPoint(width - widgets_margin_leftright, widgets_margin_topbottom), GTextAlignmentRight, config_color_widget_3, config_color_topbar_bg_local);
     var compl_y = height_full - fontsize_widgets;
-    var compl_y2 = compl_y - progress_height + REM(1);
-    widgets[w4](fctx, true, FPoint(widgets_margin_leftright, progress_no ? compl_y : compl_y2), GTextAlignmentLeft, config_color_widget_4, config_color_background);
-    widgets[w5](fctx, true, FPoint(width / 2, progress_no ? compl_y : compl_y2), GTextAlignmentCenter, config_color_widget_5, config_color_background);
-    widgets[w6](fctx, true, FPoint(width - widgets_margin_leftright, progress_no ? compl_y : compl_y2), GTextAlignmentRight, config_color_widget_6, config_color_background);
+    var compl_y2 = compl_y - progress_height + LAYOUT_PROGRESS_OVERLAP;
+    var widgets_y = progress_no ? compl_y : compl_y2;
+    draw_widget_rows(fctx, w1, w2, w3, w4, w5, w6, widgets_y, config_color_topbar_bg_local);
     var bluetooth = bluetooth_connection_service_peek();
     bluetooth_popup(fctx, ctx, bluetooth);
     fctx_deinit_context(fctx);
@@ -1238,6 +1361,13 @@ function background_update_proc(layer, ctx) {
             CONFIG_PHONE_BATTERY_EXPIRATION: +30,
             CONFIG_PHONE_BATTERY_REFRESH: +30,
             CONFIG_UPDATE_PHONEBAT_ON_SHAKE: +false,
+            CONFIG_PHONE_BATTERY_PUSH: +false,
+            CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL: +5,
+            CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL: +0,
+            CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL: "",
+            CONFIG_PRERENDER_NEXT_MINUTE: +false,
+            CONFIG_POWER_SAVER: +0,
+            CONFIG_AMBIENT: +true,
 // -- end autogen
         };
         return cloneConfig(defaults);
@@ -1321,6 +1451,13 @@ function background_update_proc(layer, ctx) {
             CONFIG_PHONE_BATTERY_EXPIRATION: +30,
             CONFIG_PHONE_BATTERY_REFRESH: +30,
             CONFIG_UPDATE_PHONEBAT_ON_SHAKE: +true,
+            CONFIG_PHONE_BATTERY_PUSH: +false,
+            CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL: +5,
+            CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL: +0,
+            CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL: "",
+            CONFIG_PRERENDER_NEXT_MINUTE: +false,
+            CONFIG_POWER_SAVER: +0,
+            CONFIG_AMBIENT: +true,
 // -- end autogen
         };
         return cloneConfig(defaults);
@@ -39,7 +39,7 @@ def enum_widget(compl, m):
 # ------------------------------------------------------------------------------
 
 version = '1.4'
-config_version = '3'
+config_version = '4'
 
 # number of timezone widgets
 num_tzs = 3
@@ -378,15 +378,49 @@ configuration = [
   {
     'key': 'CONFIG_PHONE_BATTERY_REFRESH',
     'default': '30',
-    'show_only_if': 'has_widget(ALL_PHONEBAT_WIDGET_IDS)',
+    'show_only_if': 'has_widget(ALL_PHONEBAT_WIDGET_IDS) && readConfig("CONFIG_PHONE_BATTERY_PUSH") == 0',
     'type': 'uint16_t',
   },
   {
     'key': 'CONFIG_UPDATE_PHONEBAT_ON_SHAKE',
     'default': 'false',
     'mydefault': 'true',
+    'show_only_if': 'has_widget(ALL_PHONEBAT_WIDGET_IDS) && readConfig("CONFIG_PHONE_BATTERY_PUSH") == 0',
+  },
+  {
+    'key': 'CONFIG_PHONE_BATTERY_PUSH',
+    'default': 'false',
     'show_only_if': 'has_widget(ALL_PHONEBAT_WIDGET_IDS)',
   },
+  {
+    'key': 'CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL',
+    'default': '5',
+    'show_only_if': 'has_widget(ALL_PHONEBAT_WIDGET_IDS) && readConfig("CONFIG_PHONE_BATTERY_PUSH") != 0',
+  },
+  {
+    'key': 'CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL',
+    'default': '0',
+  },
+  {
+    'key': 'CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL',
+    'default': '""',
+    'type': 'string',
+    'show_only_if': 'readConfig("CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL") > 1',
+  },
+  {
+    'key': 'CONFIG_PRERENDER_NEXT_MINUTE',
+    'default': 'false',
+    'show_only_if': 'readConfig("CONFIG_UPDATE_SECOND") == 0',
+  },
+  {
+    # battery level (in percent) at which the power saver turns on, 0 to turn it off
+    'key': 'CONFIG_POWER_SAVER',
+    'default': '0',
+  },
+  {
+    'key': 'CONFIG_AMBIENT',
+    'default': 'true',
+  },
 ]
 
 simple_config = [
@@ -416,6 +450,7 @@ widgets = [
   },
   {
     'key': 'WIDGET_WEATHER_CUR_TEMP_ICON',
+    'fonts': ['WEATHER'],
     'desc': 'Weather: Current temperature and icon',
     'group': ['WEATHER', 'WEATHERCUR'],
     'sort': 100,
@@ -428,6 +463,7 @@ widgets = [
   },
   {
     'key': 'WIDGET_WEATHER_CUR_ICON',
+    'fonts': ['WEATHER'],
     'desc': 'Weather: Current icon',
     'group': ['WEATHER', 'WEATHERCUR'],
     'sort': 100,
@@ -446,16 +482,19 @@ widgets = [
   },
   {
     'key': 'WIDGET_BLUETOOTH_DISCONLY',
+    'fonts': ['ICON'],
     'desc': 'Bluetooth (on disconnect only)',
     'sort': 200,
   },
   {
     'key': 'WIDGET_BLUETOOTH_DISCONLY_ALT',
+    'fonts': ['ICON'],
     'desc': 'Bluetooth (on disconnect only), alternative',
     'sort': 200,
   },
   {
     'key': 'WIDGET_BLUETOOTH_YESNO',
+    'fonts': ['ICON'],
     'desc': 'Bluetooth (yes/no)',
     'sort': 200,
   },
@@ -466,11 +505,13 @@ widgets = [
   },
   {
     'key': 'WIDGET_QUIET_OFFONLY',
+    'fonts': ['ICON'],
     'desc': 'Quiet time enabled (only when on)',
     'sort': 400,
   },
   {
     'key': 'WIDGET_QUIET',
+    'fonts': ['ICON'],
     'desc': 'Quiet time indicator (two icons for on/off)',
     'sort': 400,
   },
@@ -482,12 +523,14 @@ widgets = [
     #   'noton': ['basalt'],
     #   'icontext': 'J',
     #   'text': 'format_unitless((int)health_service_peek_current_value(HealthMetricHeartRateBPM))',
+    #   'health': True,
     # },
     {
       'key': 'WIDGET_STEPS',
       'desc': 'Steps',
       'icontext': 'A',
       'text': 'format_unitless(health_service_sum_today(HealthMetricStepCount))',
+      'health': True,
       'sort': 700,
     },
     {
@@ -495,6 +538,7 @@ widgets = [
       'desc': 'Steps abbreviated',
       'icontext': 'A',
       'text': 'format_thousands(health_service_sum_today(HealthMetricStepCount))',
+      'health': True,
       'sort': 700,
     },
     {
@@ -502,6 +546,7 @@ widgets = [
       'desc': 'Calories burned, resting',
       'icontext': 'K',
       'text': 'format_unitless(health_service_sum_today(HealthMetricRestingKCalories))',
+      'health': True,
       'sort': 800,
     },
     {
@@ -509,6 +554,7 @@ widgets = [
       'desc': 'Calories burned, active',
       'icontext': 'K',
       'text': 'format_unitless(health_service_sum_today(HealthMetricActiveKCalories))',
+      'health': True,
       'sort': 800,
     },
     {
@@ -516,6 +562,7 @@ widgets = [
       'desc': 'Calories burned, resting + active',
       'icontext': 'K',
       'text': 'format_unitless(health_service_sum_today(HealthMetricRestingKCalories)+health_service_sum_today(HealthMetricActiveKCalories))',
+      'health': True,
       'sort': 800,
     },
     {
@@ -523,6 +570,7 @@ widgets = [
       'desc': 'Calories burned, resting, abbreviated',
       'icontext': 'K',
       'text': 'format_thousands(health_service_sum_today(HealthMetricRestingKCalories))',
+      'health': True,
       'sort': 800,
     },
     {
@@ -530,6 +578,7 @@ widgets = [
       'desc': 'Calories burned, active, abbreviated',
       'icontext': 'K',
       'text': 'format_thousands(health_service_sum_today(HealthMetricActiveKCalories))',
+      'health': True,
       'sort': 800,
     },
     {
@@ -537,6 +586,7 @@ widgets = [
       'desc': 'Calories burned, resting + active, abbreviated',
       'icontext': 'K',
       'text': 'format_thousands(health_service_sum_today(HealthMetricRestingKCalories)+health_service_sum_today(HealthMetricActiveKCalories))',
+      'health': True,
       'sort': 800,
     },
   ],
@@ -548,21 +598,25 @@ widgets = [
   {
     'key': 'WIDGET_AMPM',
     'desc': 'AM/PM',
+    'clock': True,
     'sort': 600,
   },
   {
     'key': 'WIDGET_AMPM_LOWER',
     'desc': 'am/pm',
+    'clock': True,
     'sort': 600,
   },
   {
     'key': 'WIDGET_SECONDS',
     'desc': 'Seconds',
+    'clock': True,
     'sort': 600,
   },
   {
     'key': 'WIDGET_DAY_OF_WEEK',
     'desc': 'Day of week',
+    'clock': True,
     'sort': 600,
   },
   {
@@ -579,40 +633,47 @@ widgets = [
   'key': 'WIDGET_TZ_%d' % i,
   'desc': 'Additional timezone %d' % (i+1),
   'group': ['TZ'],
+  'clock': True,
   'sort': 500,
 }, range(num_tzs)) + [
   {
     'key': 'WIDGET_WEATHER_SUNRISE_ICON0',
+    'fonts': ['WEATHER'],
     'desc': 'Sunrise time',
     'group': ['WEATHER', 'WEATHERSUN'],
     'sort': 450,
   },
   {
     'key': 'WIDGET_WEATHER_SUNRISE_ICON1',
+    'fonts': ['WEATHER'],
     'desc': 'Sunrise time (icon on the left)',
     'group': ['WEATHER', 'WEATHERSUN'],
     'sort': 450,
   },
   {
     'key': 'WIDGET_WEATHER_SUNRISE_ICON2',
+    'fonts': ['WEATHER'],
     'desc': 'Sunrise time (icon on the right)',
     'group': ['WEATHER', 'WEATHERSUN'],
     'sort': 450,
   },
   {
     'key': 'WIDGET_WEATHER_SUNSET_ICON0',
+    'fonts': ['WEATHER'],
     'desc': 'Sunset time',
     'group': ['WEATHER', 'WEATHERSUN'],
     'sort': 450,
   },
   {
     'key': 'WIDGET_WEATHER_SUNSET_ICON1',
+    'fonts': ['WEATHER'],
     'desc': 'Sunset time (icon on the left)',
     'group': ['WEATHER', 'WEATHERSUN'],
     'sort': 450,
   },
   {
     'key': 'WIDGET_WEATHER_SUNSET_ICON2',
+    'fonts': ['WEATHER'],
     'desc': 'Sunset time (icon on the right)',
     'group': ['WEATHER', 'WEATHERSUN'],
     'sort': 450,
@@ -721,21 +782,20 @@ config_groups = [
 ]
 
 msg_keys = [
-  'WEATHER_TEMP_LOW',
-  'WEATHER_TEMP_HIGH',
-  'WEATHER_TEMP_CUR',
-  'WEATHER_ICON_CUR',
-  'WEATHER_PERC_DATA',
-  'WEATHER_PERC_DATA_LEN',
-  'WEATHER_PERC_DATA_TS',
+  'WEATHER',
   'FETCH_WEATHER',
   'WEATHER_FAILED',
   'JS_READY',
 ] + [item for sublist in map(lambda i: ['FETCH_TZ_%d' % i, 'TZ_%d' % i], range(num_tzs)) for item in sublist] + [
-  'WEATHER_SUNRISE',
-  'WEATHER_SUNSET',
   'PHONEBAT',
   'FETCH_PHONEBAT',
+  'CONFIG_HASH',
+  'CONFIG_PAGE',
+  'CONFIG_LAST',
+  'CONFIG_FAILED',
+  'WEATHER_RESYNC',
+  'NOWCAST',
+  'WARM_START',
 ]
 
 persist_keys = [
@@ -746,12 +806,91 @@ persist_keys = [
 
 perc_max_len = 30
 
+# maximum length of string configuration values (without the terminating null byte)
+stringconfig_maxlen = 50
+
+# binary weather record sent as a single byte array (MSG_KEY_WEATHER), all integers little endian:
+#   version (1), icon (1), temp_cur (2), temp_low (2), temp_high (2), sunrise (4), sunset (4),
+#   perc_data_ts (4), perc_data_len (1), followed by perc_data_len bytes of precipitation data
+weather_payload_version = 1
+weather_payload_header_len = 21
+# a record with the delta version has the same header, but instead of the full precipitation data it carries a
+# patch against the series the watch already has (shifted to the new perc_data_ts):
+#   base perc_data_ts (4), fletcher-16 checksum of the base series (2), count (1), followed by count pairs of
+#   (hour index, new value).  If the watch cannot apply it, it asks for a full record with WEATHER_RESYNC.
+weather_payload_delta_version = 2
+weather_payload_delta_header_len = 7
+
+# minute-by-minute precipitation nowcast (MSG_KEY_NOWCAST, sent along with the weather), all integers little endian:
+#   start of the first minute (4), number of minutes (1), followed by the 4-bit intensities (0-15) of the
+#   minutes, two per byte (even minutes in the low nibble)
+nowcast_minutes = 60
+nowcast_payload_header_len = 5
+
+# freshness of the data PebbleKit JS sends along with MSG_KEY_JS_READY (MSG_KEY_WARM_START), all integers little endian:
+#   age of the weather in seconds (4), age of the phone battery level in seconds (4); 0xffffffff if not included
+warm_start_payload_len = 8
+
+# configuration is sent in pages of at most this many bytes (including the page number and last page marker)
+config_page_size = 256
+
+# font size of the widgets (in rem)
+fontsize_widgets = 27
+
+# layout constants (fixed point) are computed here for every platform, and compiled in as literals (see
+# src/graphite.h).  the expression is the runtime math they replace, written with the macros of src/graphite.h; a
+# static assert in the generated code checks that both agree.  the preview still evaluates the expressions.
+# a constant can be tuned for some platforms with 'overrides' (platform name to expression); these replace the
+# expression on that platform (also in the preview), and are not checked against it.
+layout_platforms = [
+  {'name': 'aplite', 'define': 'PBL_PLATFORM_APLITE', 'width': 144, 'hr': False},
+  {'name': 'basalt', 'define': 'PBL_PLATFORM_BASALT', 'width': 144, 'hr': False},
+  {'name': 'chalk', 'define': 'PBL_PLATFORM_CHALK', 'width': 180, 'hr': False},
+  {'name': 'diorite', 'define': 'PBL_PLATFORM_DIORITE', 'width': 144, 'hr': True},
+  {'name': 'emery', 'define': 'PBL_PLATFORM_EMERY', 'width': 200, 'hr': True},
+]
+layout = [
+  # bluetooth popup
+  {'name': 'LAYOUT_POPUP_HEIGHT', 'expr': 'FIXED_ROUND(REM(60))'},
+  {'name': 'LAYOUT_POPUP_ICON_WIDTH', 'expr': 'REM(40)'},
+  {'name': 'LAYOUT_POPUP_FONTSIZE', 'expr': 'REM(23)'},
+  {'name': 'LAYOUT_POPUP_LINE_1_Y', 'expr': 'REM(7)'},
+  {'name': 'LAYOUT_POPUP_LINE_2_Y', 'expr': 'REM(35)'},
+  {'name': 'LAYOUT_POPUP_ICON_X', 'expr': 'REM(20)'},
+  {'name': 'LAYOUT_POPUP_ICON_Y', 'expr': 'REM(30)'},
+  {'name': 'LAYOUT_POPUP_ICON_FONTSIZE', 'expr': 'REM(30)'},
+  # time and date
+  {'name': 'LAYOUT_FONTSIZE_BORDER', 'expr': 'REM(20)'},
+  {'name': 'LAYOUT_FONTSIZE_MIN', 'expr': 'REM(15)'},
+  {'name': 'LAYOUT_FONTSIZE_DATE', 'expr': 'REM(28)'},
+  # top bar and rain preview
+  {'name': 'LAYOUT_TOPBAR_HEIGHT', 'expr': 'FIXED_ROUND(REM(%d) + REM(4))' % fontsize_widgets},
+  {'name': 'LAYOUT_NOWCAST_HEIGHT', 'expr': 'FIXED_ROUND(REM(6))'},
+  {'name': 'LAYOUT_RAIN_INDICATOR_HEIGHT', 'expr': 'FIXED_ROUND(REM(3))'},
+  {'name': 'LAYOUT_RAIN_BAR_SEP', 'expr': 'REM(2)'},
+  {'name': 'LAYOUT_RAIN_BAR_MAXHEIGHT', 'expr': 'REM(20)'},
+  # progress bar and widgets
+  {'name': 'LAYOUT_PROGRESS_HEIGHT', 'expr': 'REM(5)'},
+  {'name': 'LAYOUT_PROGRESS_OVERLAP', 'expr': 'REM(1)'},
+  {'name': 'LAYOUT_FONTSIZE_WIDGETS', 'expr': 'REM(%d)' % fontsize_widgets},
+  {'name': 'LAYOUT_WIDGETS_MARGIN_TOPBOTTOM', 'expr': 'REM(6)'},
+  {'name': 'LAYOUT_WIDGETS_MARGIN_LEFTRIGHT', 'expr': 'REM(8)'},
+  {'name': 'LAYOUT_WIDGETS_BOTTOM_PADDING', 'expr': 'REM(2)'},
+  {'name': 'LAYOUT_WIDGET_SEP', 'expr': 'REM(2)'},
+  {'name': 'LAYOUT_ICON_OFFSET', 'expr': 'REM(7)'},
+  {'name': 'LAYOUT_BAT_CENTER', 'expr': 'REM(21)'},
+  {'name': 'LAYOUT_STATUS_ICON_FONTSIZE', 'expr': 'REM(25)'},
+  {'name': 'LAYOUT_STATUS_ICON_Y', 'expr': 'REM(11)'},
+]
+
 files_to_render = [
   "package.template.json",
 ]
 files_to_inline_render = [
   "src/graphite.h",
   "src/graphite.c",
+  "src/fonts.c",
+  "src/prerender.c",
   "src/settings.c",
   "src/widgets.c",
   "src/widgets.h",
@@ -761,6 +900,9 @@ files_to_inline_render = [
   "config/js/preview.js",
   "screenshots/src/index.html"
 ]
+# the time zone database of the config page is trimmed down for the phone (see generate_tzdata)
+tzdata_source = "config/js/moment-timezone.js"
+tzdata_target = "src/pkjs/tzdata.js"
 files_to_maybe_inline_render = [
   "/home/stefan/dev/web/www/inc/php/tpl/graphite.tpl.php"
 ]
@@ -789,6 +931,20 @@ def get_context():
     msgkeys = add_key_id(msg_keys, 'MSG_KEY_', 100)
     persistkeys = add_key_id(persist_keys, 'PERSIST_KEY_', 201)
     assert len(config) < 100 and len(msgkeys) < 100
+    # the configuration is streamed in pages, so every page needs to fit at least one maximal string
+    assert config_page_size >= appmessage_size([stringconfig_maxlen + 1, 4, 4])
+    inbox_size = max(
+      # one page of configuration
+      config_page_size,
+      # weather update
+      appmessage_size([weather_payload_header_len + perc_max_len, nowcast_payload_header_len + nowcast_minutes // 2]),
+      # timezone update
+      appmessage_size([tz_max_datapoints * 6]),
+      # warm start: ready flag, weather, nowcast, phone battery, all timezones and the freshness tags
+      appmessage_size([4, weather_payload_header_len + perc_max_len, nowcast_payload_header_len + nowcast_minutes // 2, 4]
+        + [tz_max_datapoints * 6] * num_tzs + [warm_start_payload_len]),
+    )
+    layout_values(layout, layout_platforms)
     _context =  {
       'version': version,
       'linear_version': linear_version, # 16 bit version number
@@ -806,7 +962,18 @@ def get_context():
       'num_config_items': len(config),
       'message_keys': msgkeys + persistkeys,
       'perc_max_len': perc_max_len,
-      'fontsize_widgets': 27,
+      'stringconfig_maxlen': stringconfig_maxlen,
+      'weather_payload_version': weather_payload_version,
+      'weather_payload_header_len': weather_payload_header_len,
+      'weather_payload_delta_version': weather_payload_delta_version,
+      'weather_payload_delta_header_len': weather_payload_delta_header_len,
+      'nowcast_minutes': nowcast_minutes,
+      'nowcast_payload_header_len': nowcast_payload_header_len,
+      'warm_start_payload_len': warm_start_payload_len,
+      'inbox_size': inbox_size,
+      'config_page_size': config_page_size,
+      'layout': layout,
+      'layout_platforms': layout_platforms,
       'tz_max_datapoints': tz_max_datapoints,
       'num_tzs': num_tzs,
       'build': read_configure('BUILD'),
@@ -851,6 +1018,16 @@ def pre_process(config, simple_config, wdgts, groups):
     res = re.sub("([^0-9])0", "\\1", res)
     return res
 
+  # fonts each widget needs, besides the main font (see src/fonts.c)
+  for k in wdgts:
+    fonts = k.get('fonts', [])
+    if k.get('autogen') == 'icon_text' and k['icon'] == 'true': fonts = fonts + ['ICON']
+    k['font_flags'] = " | ".join(map(lambda f: "FONT_FLAG_%s" % (f), fonts)) or "0"
+    # widgets that show (something derived from) the current time, see src/prerender.c
+    k['clock'] = k.get('clock', False)
+    # widgets that show health data, see src/prerender.c
+    k['health'] = k.get('health', False)
+
   # resolve widget defaults
   clc = to_lookup(wdgts)
   for k in config:
@@ -862,6 +1039,33 @@ def pre_process(config, simple_config, wdgts, groups):
     if 'options' in k:
       k['options'] = map(lambda x: {'desc': (format_time(x[1][0]) + ("" if x[1][1]=="" else (" (%s)" % x[1][1]))).strip(), 'id': x[0], 'format': x[1]}, enumerate(k['options']))
 
+def layout_values(constants, platforms):
+  """Evaluate the layout expressions for every platform, the way the macros in src/graphite.h do it in C"""
+  fixed_point_scale = 16
+  for k in constants:
+    k['overrides'] = k.get('overrides', {})
+    for name in k['overrides']:
+      if name not in map(lambda p: p['name'], platforms): error("layout constant %s overrides unknown platform %s" % (k['name'], name))
+    # the preview picks the expression of the platform it draws at runtime
+    k['preview_expr'] = "".join(map(lambda o: 'platform == "%s" ? %s : ' % o, sorted(k['overrides'].items()))) + k['expr']
+  for p in platforms:
+    def PIX(x): return x * fixed_point_scale
+    def REM(x): return PIX(x) * p['width'] // 200
+    def FIXED_ROUND(x):
+      r = x % fixed_point_scale
+      return x - r if r < fixed_point_scale // 2 else x + fixed_point_scale - r
+    def IF_HR(a, b): return a if p['hr'] else b
+    env = {'PIX': PIX, 'REM': REM, 'FIXED_ROUND': FIXED_ROUND, 'IF_HR': IF_HR}
+    for k in constants:
+      if 'values' not in k: k['values'] = {}
+      value = eval(k['overrides'].get(p['name'], k['expr']), env)
+      if value < 0 or value >= 2**31: error("layout constant %s is out of range on %s" % (k['name'], p['name']))
+      k['values'][p['name']] = value
+
+def appmessage_size(value_sizes):
+  """Size of an AppMessage dictionary with values of the given sizes (1 byte header, 7 bytes per tuple header)"""
+  return 1 + sum(map(lambda s: 7 + s, value_sizes))
+
 def to_lookup(ls):
   res = {}
   for l in ls:
@@ -1023,6 +1227,37 @@ def inline_render(file):
     write_file(file, newcontents)
 
 
+def generate_tzdata(source, target):
+  """Write a compact time zone table for PebbleKit JS, using the packed zones bundled with moment-timezone.
+
+  The phone only needs the offsets and transition times of the configured zones, so abbreviations and population
+  are dropped, links are resolved to an index into the zone list, and the zones stay packed (they are unpacked on
+  first use in index.js)."""
+  data = re.search(r'\{version:"(?P<version>[^"]*)",zones:\[(?P<zones>[^\]]*)\],links:\[(?P<links>[^\]]*)\]\s*\}', read_file(source))
+  if data is None: error("could not find the time zone data in %s" % (source))
+  unquote = lambda ls: [x.strip('"') for x in ls.split('","')]
+  names = {}
+  zones = []
+  for zone in unquote(data.group('zones')):
+    parts = zone.split('|')
+    names[parts[0]] = len(zones)
+    zones.append('|'.join(parts[2:5]))
+  for link in unquote(data.group('links')):
+    parts = link.split('|')
+    names[parts[1]] = names[parts[0]]
+  out = []
+  out.append('// generated by scripts/initialize.py from %s, do not edit' % (source))
+  out.append('module.exports = {')
+  out.append('    version: "%s",' % (data.group('version')))
+  out.append('    // zone (or link) name -> index into zones')
+  out.append('    names: {%s},' % (','.join(['"%s":%d' % (n, names[n]) for n in sorted(names.keys())])))
+  out.append('    // offsets|indices|untils, packed like moment-timezone')
+  out.append('    zones: [%s]' % (','.join(['"%s"' % (z) for z in zones])))
+  out.append('};')
+  newcontents = "\n".join(out) + "\n"
+  if not os.path.exists(target) or read_file(target) != newcontents:
+    write_file(target, newcontents)
+
 def c_to_js(f):
   """Take a file in C and perform an ad-hoc translation to JavaScript"""
 
@@ -1142,6 +1377,7 @@ def main():
   for f in files_to_maybe_inline_render:
     if os.path.exists(f):
       inline_render(f)
+  generate_tzdata(tzdata_source, tzdata_target)
 
   # copy files
   files_to_copy = [
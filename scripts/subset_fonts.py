@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Compile the .ffont resources with only the glyphs the watch can actually draw.
+#
+# The character set of every font is derived from the sources:
+#  - main font: the text drawn by the widgets, the strftime formats (including the free-form ones the user can
+#    enter in the advanced settings) and the day/month names of all locales the Pebble firmware supports
+#  - weather font: the icons the phone can send (see *_ICONS in src/pkjs/index.js), and the sunrise/sunset icons
+#  - icon font: the icons drawn by the widgets and the bluetooth popup
+#
+# Usage: scripts/subset_fonts.py [--print]
+
+import sys
+import re
+import codecs
+import string
+import subprocess
+
+import initialize
+
+fctx_compiler = 'node_modules/pebble-fctx-compiler/fctx-compiler.js'
+
+c_sources = ['src/widgets.c', 'src/ui.c']
+js_source = 'src/pkjs/index.js'
+
+# characters that can show up in a user-defined format (everything else in the main font is dropped)
+free_format_chars = string.digits + string.ascii_letters + u' .:-/,%'
+
+# day and month names (full and abbreviated) that strftime produces in the locales of the Pebble firmware; only
+# the characters matter, so names that are plain ASCII are omitted
+locale_names = {
+  'de_DE': [u'März', u'Mär'],
+  'es_ES': [u'miércoles', u'sábado', u'mié', u'sáb'],
+  'fr_FR': [u'février', u'août', u'décembre', u'févr.', u'déc.'],
+  'it_IT': [u'lunedì', u'martedì', u'mercoledì', u'giovedì', u'venerdì'],
+  'pt_PT': [u'terça-feira', u'sábado', u'março', u'sáb'],
+}
+
+fonts = [
+  ('main', 'resources/fonts/OpenSans-CondensedBold.svg'),
+  ('weather', 'resources/fonts/nupe2.svg'),
+  ('icon', 'resources/fonts/fasubset.svg'),
+]
+
+def string_literals(s):
+  return map(lambda x: x.decode('unicode_escape') if '\\' in x else x, re.findall(r'"((?:[^"\\\n]|\\.)*)"', s))
+
+def strip_conversions(s):
+  """The literal characters of a printf/strftime format; numbers are added separately"""
+  return re.sub(r'%[-0-9.]*[a-zA-Z]', '', s).replace('%%', '%')
+
+def c_lines(file):
+  res = []
+  for line in codecs.open(file, 'r', 'utf-8').read().split('\n'):
+    line = line.strip()
+    if line.startswith('//') or line.startswith('#include'): continue
+    res.append(line)
+  return res
+
+def icon_chars():
+  """Icons drawn with the icon font: widget icons, and the literals drawn with (or assigned to the icon of) font_icon"""
+  res = set()
+  for w in initialize.widgets:
+    if w.get('autogen') == 'icon_text' and w['icon'] == 'true': res |= set(w['icontext'])
+  for f in c_sources:
+    for line in c_lines(f):
+      if 'font_icon' in line or re.match(r'(char\* )?icon = "', line):
+        for l in string_literals(line): res |= set(l)
+  return res
+
+def weather_chars():
+  """Icons drawn with the weather font: all icons the phone sends, and the sunrise/sunset icons"""
+  js = codecs.open(js_source, 'r', 'utf-8').read()
+  res = set()
+  for table in re.findall(r'var [A-Z]+_ICONS = \{(.*?)\};', js, re.S):
+    res |= set(''.join(re.findall(r':\s*"(.)"', table)))
+  for f in c_sources:
+    for line in c_lines(f):
+      if 'widget_weather_sunrise_sunset(fctx,' in line:
+        for l in string_literals(line): res |= set(l)
+  return res
+
+def main_chars():
+  """Text drawn with the main font"""
+  res = set(string.digits + '-') | set(free_format_chars)
+  for f in c_sources:
+    for line in c_lines(f):
+      if 'font_icon' in line or re.match(r'(char\* )?icon = "', line): continue
+      if 'widget_weather_sunrise_sunset(fctx,' in line: continue
+      for l in string_literals(line): res |= set(strip_conversions(l))
+  for k in initialize.configuration:
+    for option in k.get('options', []):
+      res |= set(strip_conversions(option[0].strip('"')))
+  for names in locale_names.values():
+    for name in names: res |= set(name)
+  return res
+
+def char_class(chars):
+  """A JavaScript regular expression character class matching exactly the given characters"""
+  return u'[%s]' % ''.join(map(lambda c: '\\' + c if c in '\\]^-[' else c, sorted(chars)))
+
+def main():
+  icons = icon_chars()
+  weather = weather_chars()
+  chars = {
+    'main': main_chars(),
+    'weather': weather,
+    'icon': icons,
+  }
+  for (name, svg) in fonts:
+    regex = char_class(chars[name])
+    if len(sys.argv) > 1 and sys.argv[1] == '--print':
+      print (u'%s (%d glyphs): %s' % (name, len(chars[name]), regex)).encode('utf-8')
+      continue
+    subprocess.check_call([fctx_compiler, '-r', regex.encode('utf-8'), svg])
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,370 @@
+// Copyright 2016 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "fonts.h"
+#include "graphite.h"
+
+/**
+ * The weather and icon fonts are reference counted.  Every consumer (the primary widgets, the secondary widgets
+ * while they are shown, and the bluetooth popup while it is shown) holds the fonts it needs, and a font is freed
+ * as soon as no consumer holds it anymore.
+ */
+typedef enum {
+    CONSUMER_PRIMARY_WIDGETS,
+    CONSUMER_SECONDARY_WIDGETS,
+    CONSUMER_BLUETOOTH_POPUP,
+    GRAPHITE_NUM_FONT_CONSUMERS
+} FontConsumer;
+
+static uint8_t font_refs[GRAPHITE_NUM_FONTS];
+static uint8_t consumer_fonts[GRAPHITE_NUM_FONT_CONSUMERS];
+
+/** Fonts (FONT_FLAG_*) needed by every widget, by widget id. */
+static const uint8_t widget_fonts[] = {
+// -- autogen
+// -- ## for key in widgets_idsorted
+// --     {{ key["font_flags"] }}, // {{ key["key"] | lower }}
+// -- ## endfor
+    0, // widget_empty
+    FONT_FLAG_WEATHER, // widget_weather_cur_temp_icon
+    0, // widget_weather_cur_temp
+    FONT_FLAG_WEATHER, // widget_weather_cur_icon
+    0, // widget_weather_low_temp
+    0, // widget_weather_high_temp
+    FONT_FLAG_ICON, // widget_bluetooth_disconly
+    FONT_FLAG_ICON, // widget_bluetooth_disconly_alt
+    FONT_FLAG_ICON, // widget_bluetooth_yesno
+    0, // widget_battery_icon
+    FONT_FLAG_ICON, // widget_quiet_offonly
+    FONT_FLAG_ICON, // widget_quiet
+    FONT_FLAG_ICON, // widget_steps_icon
+    0, // widget_steps
+    FONT_FLAG_ICON, // widget_steps_short_icon
+    0, // widget_steps_short
+    FONT_FLAG_ICON, // widget_calories_resting_icon
+    0, // widget_calories_resting
+    FONT_FLAG_ICON, // widget_calories_active_icon
+    0, // widget_calories_active
+    FONT_FLAG_ICON, // widget_calories_all_icon
+    0, // widget_calories_all
+    FONT_FLAG_ICON, // widget_calories_resting_short_icon
+    0, // widget_calories_resting_short
+    FONT_FLAG_ICON, // widget_calories_active_short_icon
+    0, // widget_calories_active_short
+    FONT_FLAG_ICON, // widget_calories_all_short_icon
+    0, // widget_calories_all_short
+    0, // widget_ampm
+    0, // widget_ampm_lower
+    0, // widget_seconds
+    0, // widget_day_of_week
+    0, // widget_battery_text
+    0, // widget_battery_text2
+    0, // widget_tz_0
+    0, // widget_tz_1
+    0, // widget_tz_2
+    FONT_FLAG_WEATHER, // widget_weather_sunrise_icon0
+    FONT_FLAG_WEATHER, // widget_weather_sunrise_icon1
+    FONT_FLAG_WEATHER, // widget_weather_sunrise_icon2
+    FONT_FLAG_WEATHER, // widget_weather_sunset_icon0
+    FONT_FLAG_WEATHER, // widget_weather_sunset_icon1
+    FONT_FLAG_WEATHER, // widget_weather_sunset_icon2
+    0, // widget_phone_battery_icon
+    0, // widget_phone_battery_text
+    0, // widget_phone_battery_text2
+    0, // widget_both_battery_icon
+    0, // widget_both_battery_flipped_icon
+    0, // widget_both_battery_text
+    0, // widget_both_battery_flipped_text
+    0, // widget_both_battery_text2
+    0, // widget_both_battery_flipped_text2
+// -- end autogen
+};
+
+/**
+ * Fonts are paged: only the header, glyph index and glyph table of a font resource are kept in memory, and glyph
+ * outlines are read from the resource when a string is drawn.  The most recently drawn outlines are kept in a small
+ * LRU cache, which easily holds the digits of the time and the glyphs of the widgets, so that redrawing the face
+ * every minute (or second) doesn't go to flash.
+ */
+#define GLYPH_CACHE_SLOTS 32
+#define GLYPH_CACHE_BYTES 3072
+
+typedef struct {
+    FFont* font;
+    ResHandle handle;
+    uint32_t path_data_start;
+} PagedFont;
+
+typedef struct {
+    FFont* font;
+    FGlyph* glyph;
+    void* outline;
+    uint32_t last_used;
+} GlyphCacheEntry;
+
+static PagedFont paged_fonts[GRAPHITE_NUM_FONTS + 1];
+static GlyphCacheEntry glyph_cache[GLYPH_CACHE_SLOTS];
+static uint32_t glyph_cache_bytes;
+static uint32_t glyph_cache_clock;
+
+static void glyph_cache_evict(int i) {
+    glyph_cache_bytes -= glyph_cache[i].glyph->path_data_length;
+    free(glyph_cache[i].outline);
+    glyph_cache[i].font = NULL;
+}
+
+/**
+ * Index of the least recently used cache entry, or -1 if the cache is empty.
+ */
+static int glyph_cache_lru() {
+    int lru = -1;
+    for (int i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+        if (glyph_cache[i].font == NULL) continue;
+        if (lru == -1 || glyph_cache[i].last_used < glyph_cache[lru].last_used) lru = i;
+    }
+    return lru;
+}
+
+/**
+ * Index of a free cache entry, evicting the least recently used entries until there is one and the cache has room
+ * for length more bytes.
+ */
+static int glyph_cache_make_room(uint16_t length) {
+    int lru;
+    while (glyph_cache_bytes + length > GLYPH_CACHE_BYTES && (lru = glyph_cache_lru()) != -1) {
+        glyph_cache_evict(lru);
+    }
+    for (int i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+        if (glyph_cache[i].font == NULL) return i;
+    }
+    lru = glyph_cache_lru();
+    glyph_cache_evict(lru);
+    return lru;
+}
+
+static PagedFont* paged_font(FFont* font) {
+    for (unsigned i = 0; i < ARRAY_LENGTH(paged_fonts); i++) {
+        if (paged_fonts[i].font == font) return &paged_fonts[i];
+    }
+    return NULL;
+}
+
+/**
+ * Load a font without its glyph outlines.  The result can be used with all of ffont and fctx, except for
+ * ffont_glyph_outline and fctx_draw_string (use font_draw_string instead).  This mirrors
+ * ffont_create_from_resource, and relies on the FFont layout of the pebble-fctx version pinned in
+ * package.template.json.
+ */
+static FFont* paged_font_create(uint32_t resource_id) {
+    PagedFont* paged = paged_font(NULL);
+    if (paged == NULL) return NULL;
+    ResHandle handle = resource_get_handle(resource_id);
+    FFont header;
+    if (resource_load_byte_range(handle, 0, (uint8_t*) &header, sizeof(FFont)) != sizeof(FFont)) return NULL;
+    size_t index_size = header.glyph_index_length * sizeof(FGlyphRange);
+    size_t table_size = header.glyph_table_length * sizeof(FGlyph);
+    size_t size = sizeof(FFont) + index_size + table_size;
+    uint8_t* data = malloc(size);
+    if (data == NULL) return NULL;
+    if (resource_load_byte_range(handle, 0, data, size) != size) {
+        free(data);
+        return NULL;
+    }
+    FFont* font = (FFont*) data;
+    font->glyph_index = (FGlyphRange*) (data + sizeof(FFont));
+    font->glyph_table = (FGlyph*) (data + sizeof(FFont) + index_size);
+    font->path_data = NULL;
+    paged->font = font;
+    paged->handle = handle;
+    paged->path_data_start = size;
+    return font;
+}
+
+static void paged_font_destroy(FFont* font) {
+    PagedFont* paged = paged_font(font);
+    if (font == NULL || paged == NULL) return;
+    for (int i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+        if (glyph_cache[i].font == font) glyph_cache_evict(i);
+    }
+    paged->font = NULL;
+    free(font);
+}
+
+/**
+ * The outline of a glyph, from the cache or read from the font resource (NULL if it can't be read, the glyph is
+ * skipped then).  The result is only valid until the next call.
+ */
+static void* glyph_outline(FFont* font, FGlyph* glyph) {
+    glyph_cache_clock += 1;
+    for (int i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+        if (glyph_cache[i].font == font && glyph_cache[i].glyph == glyph) {
+            glyph_cache[i].last_used = glyph_cache_clock;
+            return glyph_cache[i].outline;
+        }
+    }
+    PagedFont* paged = paged_font(font);
+    if (paged == NULL) return NULL;
+    uint16_t length = glyph->path_data_length;
+    int slot = glyph_cache_make_room(length);
+    void* outline = malloc(length);
+    if (outline == NULL) return NULL;
+    if (resource_load_byte_range(paged->handle, paged->path_data_start + glyph->path_data_offset, outline, length) != length) {
+        free(outline);
+        return NULL;
+    }
+    glyph_cache[slot] = (GlyphCacheEntry) {
+        .font = font,
+        .glyph = glyph,
+        .outline = outline,
+        .last_used = glyph_cache_clock,
+    };
+    glyph_cache_bytes += length;
+    return outline;
+}
+
+/**
+ * Decode the next code point of a UTF-8 string, and advance the string past it.
+ */
+static uint16_t next_code_point(const char** str) {
+    const uint8_t* s = (const uint8_t*) *str;
+    uint16_t cp;
+    if (s[0] < 0x80) {
+        cp = s[0];
+        *str += 1;
+    } else if ((s[0] & 0xe0) == 0xc0 && s[1]) {
+        cp = ((s[0] & 0x1f) << 6) | (s[1] & 0x3f);
+        *str += 2;
+    } else if ((s[0] & 0xf0) == 0xe0 && s[1] && s[2]) {
+        cp = ((s[0] & 0x0f) << 12) | ((s[1] & 0x3f) << 6) | (s[2] & 0x3f);
+        *str += 3;
+    } else {
+        cp = '?';
+        *str += 1;
+    }
+    return cp;
+}
+
+/**
+ * Draw a string with a paged font; the equivalent of fctx_draw_string.  Must be called between fctx_begin_fill and
+ * fctx_end_fill, after fctx_set_text_em_height.
+ */
+void font_draw_string(FContext* fctx, const char* str, FFont* font, GTextAlignment align, FTextAnchor anchor) {
+    FPoint advance = FPointZero;
+    if (align != GTextAlignmentLeft) {
+        fixed_t width = 0;
+        for (const char* s = str; *s;) {
+            FGlyph* glyph = ffont_glyph_info(font, next_code_point(&s));
+            if (glyph) width += glyph->horiz_adv_x;
+        }
+        advance.x = align == GTextAlignmentRight ? -width : -width / 2;
+    }
+    switch (anchor) {
+        case FTextAnchorBaseline: break;
+        case FTextAnchorMiddle: advance.y = -(font->ascent + font->descent) / 2; break;
+        case FTextAnchorCapMiddle: advance.y = -font->cap_height / 2; break;
+        case FTextAnchorTop: advance.y = -font->ascent; break;
+        case FTextAnchorCapTop: advance.y = -font->cap_height; break;
+        case FTextAnchorBottom: advance.y = -font->descent; break;
+    }
+    for (const char* s = str; *s;) {
+        FGlyph* glyph = ffont_glyph_info(font, next_code_point(&s));
+        if (glyph == NULL) continue;
+        void* outline = glyph_outline(font, glyph);
+        if (outline) fctx_draw_commands(fctx, advance, outline, glyph->path_data_length);
+        advance.x += glyph->horiz_adv_x;
+    }
+}
+
+static FFont** font_ptr(Font font) {
+    return font == FONT_WEATHER ? &font_weather : &font_icon;
+}
+
+static void font_acquire(Font font) {
+    if (font_refs[font]++ > 0) return;
+    *font_ptr(font) = paged_font_create(font == FONT_WEATHER ? RESOURCE_ID_WEATHER_FFONT : RESOURCE_ID_ICON_FFONT);
+// -- build=debug
+// --     APP_LOG(APP_LOG_LEVEL_DEBUG, "loaded font %d, %d bytes free", font, (int)heap_bytes_free());
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "loaded font %d, %d bytes free", font, (int)heap_bytes_free());
+// -- end build
+}
+
+static void font_release(Font font) {
+    if (font_refs[font] == 0 || --font_refs[font] > 0) return;
+    paged_font_destroy(*font_ptr(font));
+    *font_ptr(font) = NULL;
+// -- build=debug
+// --     APP_LOG(APP_LOG_LEVEL_DEBUG, "freed font %d, %d bytes free", font, (int)heap_bytes_free());
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "freed font %d, %d bytes free", font, (int)heap_bytes_free());
+// -- end build
+}
+
+/**
+ * Change the fonts a consumer holds.  All consumers acquire before anything is released (see update_fonts), so
+ * that a font moving from one consumer to another isn't reloaded.
+ */
+static void consumer_acquire(FontConsumer consumer, uint8_t flags) {
+    for (int i = 0; i < GRAPHITE_NUM_FONTS; i++) {
+        if ((flags & (1 << i)) && !(consumer_fonts[consumer] & (1 << i))) font_acquire(i);
+    }
+}
+static void consumer_release(FontConsumer consumer, uint8_t flags) {
+    for (int i = 0; i < GRAPHITE_NUM_FONTS; i++) {
+        if (!(flags & (1 << i)) && (consumer_fonts[consumer] & (1 << i))) font_release(i);
+    }
+    consumer_fonts[consumer] = flags;
+}
+
+static uint8_t widgets_fonts(uint8_t w1, uint8_t w2, uint8_t w3, uint8_t w4, uint8_t w5, uint8_t w6) {
+    uint8_t ids[] = {w1, w2, w3, w4, w5, w6};
+    uint8_t flags = 0;
+    for (unsigned i = 0; i < ARRAY_LENGTH(ids); i++) {
+        if (ids[i] < ARRAY_LENGTH(widget_fonts)) flags |= widget_fonts[ids[i]];
+    }
+    return flags;
+}
+
+/**
+ * Load the main font.  The fonts of the widgets are loaded by the first update_fonts, once the first frame is drawn.
+ */
+void fonts_init() {
+    font_main = paged_font_create(RESOURCE_ID_MAIN_FFONT);
+}
+
+/**
+ * Load and free fonts to match what is currently on screen.  Needs to be called whenever the configured widgets
+ * change, or the secondary widgets or bluetooth popup are shown or hidden.
+ */
+void update_fonts() {
+    uint8_t flags[GRAPHITE_NUM_FONT_CONSUMERS];
+    flags[CONSUMER_PRIMARY_WIDGETS] = widgets_fonts(config_widget_1, config_widget_2, config_widget_3,
+                                                    config_widget_4, config_widget_5, config_widget_6);
+    // pre-rendering (see prerender.c) draws the secondary widgets while they are hidden
+    bool secondary = (show_secondary_widgets && config_2nd_widgets) || prerender_secondary_enabled();
+    flags[CONSUMER_SECONDARY_WIDGETS] = !secondary ? 0 :
+                                        widgets_fonts(config_widget_7, config_widget_8, config_widget_9,
+                                                      config_widget_10, config_widget_11, config_widget_12);
+    flags[CONSUMER_BLUETOOTH_POPUP] = show_bluetooth_popup ? FONT_FLAG_ICON : 0;
+    for (int i = 0; i < GRAPHITE_NUM_FONT_CONSUMERS; i++) consumer_acquire(i, flags[i]);
+    for (int i = 0; i < GRAPHITE_NUM_FONT_CONSUMERS; i++) consumer_release(i, flags[i]);
+}
+
+/**
+ * Free all fonts.
+ */
+void fonts_deinit() {
+    for (int i = 0; i < GRAPHITE_NUM_FONT_CONSUMERS; i++) consumer_release(i, 0);
+    paged_font_destroy(font_main);
+    font_main = NULL;
+}
@@ -0,0 +1,36 @@
+// Copyright 2016 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef GRAPHITE_FONTS_H
+#define GRAPHITE_FONTS_H
+
+#include "graphite.h"
+
+/** Fonts that are only loaded while something on screen needs them (the main font is always loaded). */
+typedef enum {
+    FONT_WEATHER,
+    FONT_ICON,
+    GRAPHITE_NUM_FONTS
+} Font;
+
+#define FONT_FLAG_WEATHER (1 << FONT_WEATHER)
+#define FONT_FLAG_ICON (1 << FONT_ICON)
+
+void fonts_init();
+void update_fonts();
+void fonts_deinit();
+void font_draw_string(FContext* fctx, const char* str, FFont* font, GTextAlignment align, FTextAnchor anchor);
+
+#endif //GRAPHITE_FONTS_H
@@ -87,6 +87,10 @@ uint8_t config_quiet_col = false;
 uint16_t config_phone_battery_expiration = 30;
 uint16_t config_phone_battery_refresh = 30;
 uint8_t config_update_phonebat_on_shake = false;
+uint8_t config_phone_battery_push = false;
+uint8_t config_prerender_next_minute = false;
+uint8_t config_power_saver = 0;
+uint8_t config_ambient = true;
 // -- end autogen
 
 
@@ -114,32 +118,43 @@ fixed_t fontsize_widgets;
 /** Is the bluetooth popup current supposed to be shown? */
 bool show_bluetooth_popup;
 
-/** The timer for the bluetooth popup */
-AppTimer *timer_bluetooth_popup;
-
 /** The current weather information. */
 Weather weather;
 
+/** The precipitation nowcast. */
+Nowcast nowcast;
+
 /** The current phone battery information. */
 PhoneBattery phonebat;
-AppTimer * phone_battery_request_timer;
+
+/** When the connection to the phone was lost (0 while connected). */
+time_t phonebat_disconnected;
 
 /** Is the JS runtime ready? */
 bool js_ready;
 
-/** A timer used to schedule weather updates. */
-AppTimer * weather_request_timer;
-
 /** The timezone information. */
 TimeZoneInfo tzinfo;
 
-/** Timer for taps. */
-AppTimer *timer_tap;
+/** Are we subscribed to taps? */
 bool tap_subscribed = false;
 
 /** Should we show the secondary set of widgets? */
 bool show_secondary_widgets;
 
+/** Is the power saver on (see update_power_saver)? */
+bool power_saver;
+
+/** Is the ambient mode on (see update_ambient_mode)? */
+bool ambient_mode;
+
+/** How far the staged startup is. */
+StartupStage startup_stage = STARTUP_FIRST_FRAME;
+
+/** When init started, to measure the time to the first and the first complete frame. */
+static time_t startup_time_s;
+static uint16_t startup_time_ms;
+
 
 
 ////////////////////////////////////////////
@@ -157,11 +172,78 @@ bool user_sleeping() {
     }
 }
 
+/**
+ * Is the watch off the wrist?  Only watches with a heart rate monitor can tell: it doesn't report a heart rate
+ * then, and no steps were counted for a while.
+ */
+static bool user_off_wrist() {
+    time_t now = time(NULL);
+    time_t idle_start = now - GRAPHITE_AMBIENT_IDLE_MIN * 60;
+    if (!(health_service_metric_accessible(HealthMetricHeartRateBPM, now, now) & HealthServiceAccessibilityMaskAvailable)) {
+        return false;
+    }
+    if (health_service_peek_current_value(HealthMetricHeartRateBPM) != 0) return false;
+    return health_service_sum(HealthMetricStepCount, idle_start, now) == 0;
+}
+
+/**
+ * Are background fetches (weather and phone battery) suspended?
+ */
+bool fetches_suspended() {
+    return power_saver || ambient_mode;
+}
+
+/**
+ * Should the ambient mode be on?
+ */
+static bool ambient_mode_wanted() {
+    return config_ambient && (user_sleeping() || user_off_wrist());
+}
+
+/**
+ * Turn the ambient mode on or off.  While the user sleeps or the watch is off the wrist, the watchface still redraws
+ * the time every minute, but the top bar and widgets are frozen (see prerender.c), which keeps that redraw cheap, and
+ * taps and background fetches are suspended.  Once the user wakes up everything is refreshed, and outdated data is
+ * fetched.
+ */
+void update_ambient_mode() {
+    bool on = ambient_mode_wanted();
+    if (on == ambient_mode) return;
+    ambient_mode = on;
+// -- build=debug
+// --     APP_LOG(APP_LOG_LEVEL_INFO, "ambient mode %s", ambient_mode ? "on" : "off");
+    APP_LOG(APP_LOG_LEVEL_INFO, "ambient mode %s", ambient_mode ? "on" : "off");
+// -- end build
+    if (ambient_mode && show_secondary_widgets) {
+        cancel_task(TASK_TAP);
+        show_secondary_widgets = false;
+    }
+    subscribe_tick(true);
+    subscribe_tap();
+    update_fonts();
+    prerender_invalidate();
+    if (!ambient_mode) prerender_frozen_free();
+    // the catch-up refresh: only what got outdated in the meantime is fetched
+    update_weather(false);
+    update_phonebat(false);
+    layer_mark_dirty(layer_background);
+}
+
+void handle_health(HealthEventType event, void *context) {
+    if (event == HealthEventSleepUpdate || event == HealthEventMovementUpdate || event == HealthEventSignificantUpdate) {
+        update_ambient_mode();
+    }
+}
+
 /**
  * Handler for time ticks.
  */
 void handle_second_tick(struct tm *tick_time, TimeUnits units_changed) {
-    if (config_update_second == 0 || (tick_time->tm_sec == 0) || ((tick_time->tm_sec % config_update_second) == 0)) {
+    if ((units_changed & MINUTE_UNIT) != 0) {
+        // taking the watch off (or putting it back on) comes without an event, so check every minute
+        update_ambient_mode();
+    }
+    if ((config_update_second == 0 || (tick_time->tm_sec == 0) || ((tick_time->tm_sec % config_update_second) == 0))) {
         layer_mark_dirty(layer_background);
     }
     if (!quiet_time_is_active() && config_hourly_vibrate) {
@@ -173,18 +255,31 @@ void handle_second_tick(struct tm *tick_time, TimeUnits units_changed) {
             }
         }
     }
+    if ((units_changed & MINUTE_UNIT) != 0) {
+        advance_nowcast();
+        // run any deferred work that is due, so it doesn't need its own wakeup
+        scheduler_minute_tick();
+    }
 }
 
 void timer_callback_bluetooth_popup(void *data) {
     show_bluetooth_popup = false;
-    timer_bluetooth_popup = NULL;
+    update_fonts();
     layer_mark_dirty(layer_background);
 }
 
 void handle_bluetooth(bool connected) {
     // redraw background (to turn on/off the logo)
+    prerender_invalidate();
     layer_mark_dirty(layer_background);
 
+    // refresh intervals are stretched while disconnected, so reschedule (and catch up if needed)
+    if (connected) {
+        update_weather(false);
+        update_phonebat(false);
+    }
+    phonebat_disconnected = connected ? 0 : time(NULL);
+
     bool show_popup = false;
     bool vibrate = false;
     if ((config_message_reconnect && connected) || (config_message_disconnect && !connected)) {
@@ -208,12 +303,56 @@ void handle_bluetooth(bool connected) {
     // show popup
     if (show_popup) {
         show_bluetooth_popup = true;
-        if (timer_bluetooth_popup) {
-            app_timer_reschedule(timer_bluetooth_popup, GRAPHITE_BLUETOOTH_POPUP_MS);
-        } else {
-            timer_bluetooth_popup = app_timer_register(GRAPHITE_BLUETOOTH_POPUP_MS, timer_callback_bluetooth_popup,
-                                                       NULL);
-        }
+        update_fonts();
+        schedule_task(TASK_BLUETOOTH_POPUP, GRAPHITE_BLUETOOTH_POPUP_MS, 0, timer_callback_bluetooth_popup);
+    }
+}
+
+/**
+ * Milliseconds since the start of init (only logged in debug builds).
+ */
+static int __attribute__((unused)) startup_elapsed_ms() {
+    time_t s;
+    uint16_t ms;
+    time_ms(&s, &ms);
+    return (int)((s - startup_time_s) * 1000 + ms - startup_time_ms);
+}
+
+/**
+ * The staged startup: every call does one step, and then yields to the event loop (so that drawing and input
+ * aren't held up) before the next.
+ */
+static void startup_continue(void *unused) {
+    if (startup_stage == STARTUP_LOAD_DATA) {
+        read_persisted_data();
+        startup_stage = STARTUP_LOAD_FONTS;
+        schedule_task(TASK_STARTUP, 0, 0, startup_continue);
+    } else if (startup_stage == STARTUP_LOAD_FONTS) {
+        update_fonts();
+        // any frame cached so far was drawn with the fallback fonts
+        prerender_invalidate();
+        startup_stage = STARTUP_FULL_FRAME;
+        layer_mark_dirty(layer_background);
+    }
+}
+
+/**
+ * Called after every frame, to move the staged startup along.
+ */
+void startup_frame_drawn() {
+    if (startup_stage == STARTUP_FIRST_FRAME) {
+// -- build=debug
+// --         APP_LOG(APP_LOG_LEVEL_DEBUG, "time to first pixel: %d ms", startup_elapsed_ms());
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "time to first pixel: %d ms", startup_elapsed_ms());
+// -- end build
+        startup_stage = STARTUP_LOAD_DATA;
+        schedule_task(TASK_STARTUP, 0, 0, startup_continue);
+    } else if (startup_stage == STARTUP_FULL_FRAME) {
+// -- build=debug
+// --         APP_LOG(APP_LOG_LEVEL_DEBUG, "time to complete frame: %d ms", startup_elapsed_ms());
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "time to complete frame: %d ms", startup_elapsed_ms());
+// -- end build
+        startup_stage = STARTUP_DONE;
     }
 }
 
@@ -226,16 +365,14 @@ void window_load(Window *window) {
 
     // create layer
     layer_background = layer_create(bounds);
-    layer_set_update_proc(layer_background, background_update_proc);
+    layer_set_update_proc(layer_background, frame_update_proc);
     layer_add_child(window_layer, layer_background);
 
-    // load fonts
-    font_main = ffont_create_from_resource(RESOURCE_ID_MAIN_FFONT);
-    font_weather = ffont_create_from_resource(RESOURCE_ID_WEATHER_FFONT);
-    font_icon = ffont_create_from_resource(RESOURCE_ID_ICON_FFONT);
-
     // initialize
     show_bluetooth_popup = false;
+
+    // only the main font is needed for the first frame
+    fonts_init();
 }
 
 /**
@@ -243,9 +380,8 @@ void window_load(Window *window) {
  */
 void window_unload(Window *window) {
     layer_destroy(layer_background);
-    ffont_destroy(font_main);
-    ffont_destroy(font_weather);
-    ffont_destroy(font_icon);
+    fonts_deinit();
+    prerender_deinit();
 }
 
 void subscribe_tick(bool also_unsubscribe) {
@@ -253,32 +389,74 @@ void subscribe_tick(bool also_unsubscribe) {
         tick_timer_service_unsubscribe();
     }
     TimeUnits unit = MINUTE_UNIT;
-    if (config_update_second > 0) {
+    if (config_update_second > 0 && !power_saver && !ambient_mode) {
         unit = SECOND_UNIT;
     }
     tick_timer_service_subscribe(unit, handle_second_tick);
 }
 
+/**
+ * Should the power saver be on?  It is whenever the battery is at or below the configured level, and isn't charging.
+ */
+static bool power_saver_wanted() {
+    BatteryChargeState state = battery_state_service_peek();
+    if (config_power_saver == 0 || state.is_charging || state.is_plugged) return false;
+    return state.charge_percent <= config_power_saver;
+}
+
+/**
+ * Turn the power saver on or off.  While it is on, the watchface ticks once a minute, skips the rain preview,
+ * pre-rendering and anti-aliasing of shapes, draws text with the system fonts, and doesn't fetch anything in the
+ * background.  Needs to be called whenever the battery state or the configuration changes.
+ */
+void update_power_saver() {
+    bool on = power_saver_wanted();
+    if (on == power_saver) return;
+    power_saver = on;
+// -- build=debug
+// --     APP_LOG(APP_LOG_LEVEL_INFO, "power saver %s", power_saver ? "on" : "off");
+    APP_LOG(APP_LOG_LEVEL_INFO, "power saver %s", power_saver ? "on" : "off");
+// -- end build
+    subscribe_tick(true);
+    update_fonts();
+    prerender_invalidate();
+    // fetches are stopped by update_weather/update_phonebat, and catch up (if needed) once they are allowed again
+    update_weather(false);
+    update_phonebat(false);
+    layer_mark_dirty(layer_background);
+}
+
 void handle_battery(BatteryChargeState new_state) {
+    update_power_saver();
+    prerender_invalidate();
+    layer_mark_dirty(layer_background);
+}
+
+void handle_unobstructed_will_change(GRect final_unobstructed_screen_area, void *context) {
+    prerender_peek_begin();
+}
+
+void handle_unobstructed_change(AnimationProgress progress, void *context) {
+    layer_mark_dirty(layer_background);
+}
+
+void handle_unobstructed_did_change(void *context) {
+    prerender_peek_end();
     layer_mark_dirty(layer_background);
 }
 
 void end_tap(void* data) {
-    timer_tap = NULL;
     show_secondary_widgets = false;
+    update_fonts();
     layer_mark_dirty(layer_background);
 }
 
 void handle_tap(AccelAxisType axis, int32_t direction) {
     show_secondary_widgets = true;
-    if (timer_tap) {
-        app_timer_reschedule(timer_tap, config_timeout_2nd_widgets);
-    } else {
-        timer_tap = app_timer_register(config_timeout_2nd_widgets, end_tap,
-                                                   NULL);
-    }
+    update_fonts();
+    schedule_task(TASK_TAP, config_timeout_2nd_widgets, 0, end_tap);
     layer_mark_dirty(layer_background);
-    if (config_update_phonebat_on_shake) ask_for_update(MSG_KEY_FETCH_PHONEBAT);
+    if (config_update_phonebat_on_shake && !config_phone_battery_push && !power_saver) ask_for_update(MSG_KEY_FETCH_PHONEBAT);
 }
 
 void subscribe_tap() {
@@ -286,7 +464,7 @@ void subscribe_tap() {
         accel_tap_service_unsubscribe();
         tap_subscribed = false;
     }
-    if (!config_2nd_widgets) return;
+    if (!config_2nd_widgets || ambient_mode) return;
     accel_tap_service_subscribe(handle_tap);
     tap_subscribed = true;
 }
@@ -295,7 +473,12 @@ void subscribe_tap() {
  * Initialization.
  */
 void init() {
+    time_ms(&startup_time_s, &startup_time_ms);
+    srand(time(NULL));
+    // only the configuration is read here; everything else is loaded once the first frame is on screen
     read_config_all();
+    power_saver = power_saver_wanted();
+    ambient_mode = ambient_mode_wanted();
 
     window = window_create();
     window_set_window_handlers(window, (WindowHandlers) {
@@ -308,9 +491,17 @@ void init() {
     bluetooth_connection_service_subscribe(handle_bluetooth);
     battery_state_service_subscribe(handle_battery);
     subscribe_tap();
+    health_service_events_subscribe(handle_health, NULL);
+    unobstructed_area_service_subscribe((UnobstructedAreaHandlers) {
+            .will_change = handle_unobstructed_will_change,
+            .change = handle_unobstructed_change,
+            .did_change = handle_unobstructed_did_change,
+    }, NULL);
 
     app_message_open(GRAPHITE_INBOX_SIZE, GRAPHITE_OUTBOX_SIZE);
     app_message_register_inbox_received(inbox_received_handler);
+    app_message_register_outbox_sent(outbox_sent_handler);
+    app_message_register_outbox_failed(outbox_failed_handler);
 }
 
 /**
@@ -321,6 +512,9 @@ void deinit() {
     battery_state_service_unsubscribe();
     bluetooth_connection_service_unsubscribe();
     accel_tap_service_unsubscribe();
+    health_service_events_unsubscribe();
+    unobstructed_area_service_unsubscribe();
+    scheduler_deinit();
 
     window_destroy(window);
 
@@ -93,37 +93,40 @@
 #define CONFIG_PHONE_BATTERY_EXPIRATION 67
 #define CONFIG_PHONE_BATTERY_REFRESH 68
 #define CONFIG_UPDATE_PHONEBAT_ON_SHAKE 69
+#define CONFIG_PHONE_BATTERY_PUSH 70
+#define CONFIG_PRERENDER_NEXT_MINUTE 74
+#define CONFIG_POWER_SAVER 75
+#define CONFIG_AMBIENT 76
 // -- end autogen
 
 // -- autogen
 // -- #define GRAPHITE_N_CONFIG {{ num_config_items }}
-#define GRAPHITE_N_CONFIG 69
+#define GRAPHITE_N_CONFIG 76
 // -- end autogen
 
 // -- autogen
 // -- ## for key in message_keys
 // -- #define {{ key["key"] }} {{ key["id"] }}
 // -- ## endfor
-#define MSG_KEY_WEATHER_TEMP_LOW 100
-#define MSG_KEY_WEATHER_TEMP_HIGH 101
-#define MSG_KEY_WEATHER_TEMP_CUR 102
-#define MSG_KEY_WEATHER_ICON_CUR 103
-#define MSG_KEY_WEATHER_PERC_DATA 104
-#define MSG_KEY_WEATHER_PERC_DATA_LEN 105
-#define MSG_KEY_WEATHER_PERC_DATA_TS 106
-#define MSG_KEY_FETCH_WEATHER 107
-#define MSG_KEY_WEATHER_FAILED 108
-#define MSG_KEY_JS_READY 109
-#define MSG_KEY_FETCH_TZ_0 110
-#define MSG_KEY_TZ_0 111
-#define MSG_KEY_FETCH_TZ_1 112
-#define MSG_KEY_TZ_1 113
-#define MSG_KEY_FETCH_TZ_2 114
-#define MSG_KEY_TZ_2 115
-#define MSG_KEY_WEATHER_SUNRISE 116
-#define MSG_KEY_WEATHER_SUNSET 117
-#define MSG_KEY_PHONEBAT 118
-#define MSG_KEY_FETCH_PHONEBAT 119
+#define MSG_KEY_WEATHER 100
+#define MSG_KEY_FETCH_WEATHER 101
+#define MSG_KEY_WEATHER_FAILED 102
+#define MSG_KEY_JS_READY 103
+#define MSG_KEY_FETCH_TZ_0 104
+#define MSG_KEY_TZ_0 105
+#define MSG_KEY_FETCH_TZ_1 106
+#define MSG_KEY_TZ_1 107
+#define MSG_KEY_FETCH_TZ_2 108
+#define MSG_KEY_TZ_2 109
+#define MSG_KEY_PHONEBAT 110
+#define MSG_KEY_FETCH_PHONEBAT 111
+#define MSG_KEY_CONFIG_HASH 112
+#define MSG_KEY_CONFIG_PAGE 113
+#define MSG_KEY_CONFIG_LAST 114
+#define MSG_KEY_CONFIG_FAILED 115
+#define MSG_KEY_WEATHER_RESYNC 116
+#define MSG_KEY_NOWCAST 117
+#define MSG_KEY_WARM_START 118
 #define PERSIST_KEY_WEATHER 201
 #define PERSIST_KEY_TZ 202
 #define PERSIST_KEY_PHONEBAT 203
@@ -134,7 +137,10 @@
 //// Configuration values
 ////////////////////////////////////////////
 
+// -- autogen
+// -- #define GRAPHITE_STRINGCONFIG_MAXLEN {{ stringconfig_maxlen }}
 #define GRAPHITE_STRINGCONFIG_MAXLEN 50
+// -- end autogen
 
 // -- autogen
 // -- ## for key in configuration
@@ -203,6 +209,10 @@ extern uint8_t config_quiet_col;
 extern uint16_t config_phone_battery_expiration;
 extern uint16_t config_phone_battery_refresh;
 extern uint8_t config_update_phonebat_on_shake;
+extern uint8_t config_phone_battery_push;
+extern uint8_t config_prerender_next_minute;
+extern uint8_t config_power_saver;
+extern uint8_t config_ambient;
 // -- end autogen
 
 
@@ -233,44 +243,91 @@ extern FFont* font_icon;
 extern fixed_t fontsize_widgets;
 
 extern bool show_bluetooth_popup;
-extern AppTimer *timer_bluetooth_popup;
 extern bool show_secondary_widgets;
-
-// this definition should be updated whenever the Weather struct, or it's semantic meaning changes.  this ensures that no outdated values are read from storage
+extern bool power_saver;
+extern bool ambient_mode;
+
+// the startup is staged, so that the first frame only needs the configuration and the main font
+typedef enum {
+    STARTUP_FIRST_FRAME, // only the background and the time are drawn
+    STARTUP_LOAD_DATA, // persisted weather, phone battery and timezones are read on the next event-loop turn
+    STARTUP_LOAD_FONTS, // the fonts of the widgets are loaded on the turn after that
+    STARTUP_FULL_FRAME, // everything is loaded, the first complete frame is drawn
+    STARTUP_DONE,
+} StartupStage;
+extern StartupStage startup_stage;
+
+// this definition should be updated whenever the persisted weather format, or it's semantic meaning changes.  this ensures that no outdated values are read from storage
 #define GRAPHITE_WEATHER_VERSION 3
 // -- autogen
 // -- #define GRAPHITE_WEATHER_PERC_MAX_LEN {{ perc_max_len }}
 #define GRAPHITE_WEATHER_PERC_MAX_LEN 30
 // -- end autogen
 #define GRAPHITE_UNKNOWN_WEATHER 32767
+// the weather arrives as a single binary record, see weather_payload_* in scripts/initialize.py for the layout
+// -- autogen
+// -- #define GRAPHITE_WEATHER_PAYLOAD_VERSION {{ weather_payload_version }}
+// -- #define GRAPHITE_WEATHER_PAYLOAD_HEADER_LEN {{ weather_payload_header_len }}
+// -- #define GRAPHITE_WEATHER_PAYLOAD_DELTA_VERSION {{ weather_payload_delta_version }}
+// -- #define GRAPHITE_WEATHER_PAYLOAD_DELTA_HEADER_LEN {{ weather_payload_delta_header_len }}
+#define GRAPHITE_WEATHER_PAYLOAD_VERSION 1
+#define GRAPHITE_WEATHER_PAYLOAD_HEADER_LEN 21
+#define GRAPHITE_WEATHER_PAYLOAD_DELTA_VERSION 2
+#define GRAPHITE_WEATHER_PAYLOAD_DELTA_HEADER_LEN 7
+// -- end autogen
+
+// the following structs are naturally aligned (they are read on every frame); they are explicitly
+// serialized into a compact, versioned format when persisted (see settings.c)
 typedef struct {
-    uint8_t version;
     time_t timestamp;
-    int8_t icon;
+    time_t perc_data_ts;
+    time_t sunrise;
+    time_t sunset;
     int16_t temp_cur;
     int16_t temp_low;
     int16_t temp_high;
-    uint8_t perc_data[GRAPHITE_WEATHER_PERC_MAX_LEN];
+    int8_t icon;
     uint8_t perc_data_len; // maybe not all perc data items are valid
-    time_t perc_data_ts;
-    time_t sunrise;
-    time_t sunset;
     bool failed;
-} __attribute__((__packed__)) Weather;
+    uint8_t perc_data[GRAPHITE_WEATHER_PERC_MAX_LEN];
+} Weather;
 
 extern Weather weather;
 extern bool js_ready;
-extern AppTimer * weather_request_timer;
 
-// this definition should be updated whenever the Weather struct, or it's semantic meaning changes.  this ensures that no outdated values are read from storage
+// freshness tags sent along with MSG_KEY_JS_READY (see warm_start_* in scripts/initialize.py)
+// -- autogen
+// -- #define GRAPHITE_WARM_START_PAYLOAD_LEN {{ warm_start_payload_len }}
+#define GRAPHITE_WARM_START_PAYLOAD_LEN 8
+// -- end autogen
+#define GRAPHITE_WARM_START_UNKNOWN_AGE 0xffffffff
+
+// minute-by-minute precipitation for the next hour (see nowcast_payload_* in scripts/initialize.py)
+// -- autogen
+// -- #define GRAPHITE_NOWCAST_MINUTES {{ nowcast_minutes }}
+// -- #define GRAPHITE_NOWCAST_PAYLOAD_HEADER_LEN {{ nowcast_payload_header_len }}
+#define GRAPHITE_NOWCAST_MINUTES 60
+#define GRAPHITE_NOWCAST_PAYLOAD_HEADER_LEN 5
+// -- end autogen
+#define GRAPHITE_NOWCAST_MAX_LEVEL 15
+
+// a ring buffer of 4-bit intensities, which is advanced every minute
+typedef struct {
+    time_t start; // the minute stored at head (0 if there is no nowcast)
+    uint8_t head;
+    uint8_t data[GRAPHITE_NOWCAST_MINUTES / 2];
+} Nowcast;
+
+extern Nowcast nowcast;
+
+// this definition should be updated whenever the persisted phone battery format, or it's semantic meaning changes.  this ensures that no outdated values are read from storage
 #define GRAPHITE_PHONE_BATTERY_VERSION 1
 typedef struct {
-    uint8_t version;
-    uint8_t level;
     time_t timestamp;
-} __attribute__((__packed__)) PhoneBattery;
+    uint8_t level;
+} PhoneBattery;
 extern PhoneBattery phonebat;
-extern AppTimer * phone_battery_request_timer;
+extern time_t phonebat_disconnected;
 
 // -- autogen
 // -- #define GRAPHITE_NUM_TZS {{ num_tzs }}
@@ -281,15 +338,14 @@ extern AppTimer * phone_battery_request_timer;
 #define GRAPHITE_TZ_DATA_VERSION 1
 
 typedef struct {
-    bool valid;
     int32_t untils[GRAPHITE_TZ_MAX_DATAPOINTS];
     int16_t offsets[GRAPHITE_TZ_MAX_DATAPOINTS];
-} __attribute__((__packed__)) TZData;
+    bool valid;
+} TZData;
 
 typedef struct {
-    uint16_t version;
     TZData data[GRAPHITE_NUM_TZS];
-} __attribute__((__packed__)) TimeZoneInfo;
+} TimeZoneInfo;
 extern TimeZoneInfo tzinfo;
 
 
@@ -299,14 +355,39 @@ extern TimeZoneInfo tzinfo;
 
 #define COLOR(c) ((GColor8) { .argb = (c) })
 #define MAX(x,y) ((x) < (y) ? (y) : (x))
+#define MIN(x,y) ((x) < (y) ? (x) : (y))
 
 #define GRAPHITE_BLUETOOTH_POPUP_MS 5000
 
+// background fetches may be delayed by this much, so they can ride along with the minute tick
+#define GRAPHITE_SCHEDULER_FETCH_SLACK_MS (60 * 1000)
+// the scheduler timer never sleeps longer than this (it simply re-arms)
+#define GRAPHITE_SCHEDULER_MAX_DELAY_MS (24 * 60 * 60 * 1000)
+
+// ambient mode (see update_ambient_mode)
+#define GRAPHITE_AMBIENT_IDLE_MIN 30 // off the wrist means no heart rate, and no steps for this many minutes
+
+// the next minute is pre-rendered this long before it starts (if CONFIG_PRERENDER_NEXT_MINUTE is on)
+#define GRAPHITE_PRERENDER_LEAD_MS 3000
+// outdated secondary widgets are pre-rendered in a separate redraw this long after the frame that noticed it
+#define GRAPHITE_PRERENDER_SECONDARY_DELAY_MS 1000
+
+// adaptive refresh scheduling (intervals in minutes)
+#define GRAPHITE_REFRESH_MAX_STRETCH 8 // never wait longer than this multiple of the configured interval
+#define GRAPHITE_REFRESH_MAX_UNCHANGED 2 // every unchanged refresh doubles the interval, up to this many times
+#define GRAPHITE_REFRESH_RAIN_PROB 30 // precipitation probability (in percent) that counts as imminent rain
+#define GRAPHITE_REFRESH_RAIN_INTERVAL 15 // refresh at least this often when rain is imminent
+#define GRAPHITE_REFRESH_MAX_BACKOFF 5 // the failure retry interval doubles at most this many times
+#define GRAPHITE_REFRESH_JITTER_PERCENT 20 // randomize retries by up to this much
+
 #define GRAPHITE_OUTBOX_SIZE 100
-#define GRAPHITE_WEATHER_N_INTS 6 // 3 temps + 1 icon + data len + data timestamp
-#define GRAPHITE_WEATHER_HOURS 30
-// 100 + an upper bound for all the configuration items we have OR the amount of data sent as weather update
-#define GRAPHITE_INBOX_SIZE (100 + MAX(1 + (GRAPHITE_N_CONFIG) * (7+4), GRAPHITE_WEATHER_N_INTS * 4 + GRAPHITE_WEATHER_HOURS * 4))
+// a message that didn't make it to the phone is retried after this long (if it carried anything that must arrive)
+#define GRAPHITE_OUTBOX_RETRY_MS 10000
+// the largest message we can receive (computed by the generator from the configuration page size, weather and tz payloads)
+// -- autogen
+// -- #define GRAPHITE_INBOX_SIZE {{ inbox_size }}
+#define GRAPHITE_INBOX_SIZE 256
+// -- end autogen
 
 #define PIX(x) (INT_TO_FIXED(x))
 // returns a fixed_t value that corresponds to a relatively scaled version, where 1 rem is 1/200 of the screen width
@@ -320,10 +401,200 @@ extern TimeZoneInfo tzinfo;
 #define IF_HR(a, b) (b)
 #endif
 
+// layout constants of the platform being built, computed by the generator (see layout in scripts/initialize.py);
+// each is checked against the runtime math above that it replaces, unless it is overridden for some platform
+// -- autogen
+// -- ## for p in layout_platforms
+// -- #{{ "if" if loop.first else "elif" }} defined({{ p.define }})
+// -- ## for l in layout
+// -- #define {{ l.name }} {{ l["values"][p.name] }}
+// -- ## endfor
+// -- ## endfor
+// -- #else
+// -- #error "no layout constants for this platform"
+// -- #endif
+// -- ## for l in layout if not l.overrides
+// -- _Static_assert({{ l.name }} == {{ l.expr }}, "{{ l.name }} does not match {{ l.expr }}");
+// -- ## endfor
+#if defined(PBL_PLATFORM_APLITE)
+#define LAYOUT_POPUP_HEIGHT 688
+#define LAYOUT_POPUP_ICON_WIDTH 460
+#define LAYOUT_POPUP_FONTSIZE 264
+#define LAYOUT_POPUP_LINE_1_Y 80
+#define LAYOUT_POPUP_LINE_2_Y 403
+#define LAYOUT_POPUP_ICON_X 230
+#define LAYOUT_POPUP_ICON_Y 345
+#define LAYOUT_POPUP_ICON_FONTSIZE 345
+#define LAYOUT_FONTSIZE_BORDER 230
+#define LAYOUT_FONTSIZE_MIN 172
+#define LAYOUT_FONTSIZE_DATE 322
+#define LAYOUT_TOPBAR_HEIGHT 352
+#define LAYOUT_NOWCAST_HEIGHT 64
+#define LAYOUT_RAIN_INDICATOR_HEIGHT 32
+#define LAYOUT_RAIN_BAR_SEP 23
+#define LAYOUT_RAIN_BAR_MAXHEIGHT 230
+#define LAYOUT_PROGRESS_HEIGHT 57
+#define LAYOUT_PROGRESS_OVERLAP 11
+#define LAYOUT_FONTSIZE_WIDGETS 311
+#define LAYOUT_WIDGETS_MARGIN_TOPBOTTOM 69
+#define LAYOUT_WIDGETS_MARGIN_LEFTRIGHT 92
+#define LAYOUT_WIDGETS_BOTTOM_PADDING 23
+#define LAYOUT_WIDGET_SEP 23
+#define LAYOUT_ICON_OFFSET 80
+#define LAYOUT_BAT_CENTER 241
+#define LAYOUT_STATUS_ICON_FONTSIZE 288
+#define LAYOUT_STATUS_ICON_Y 126
+#elif defined(PBL_PLATFORM_BASALT)
+#define LAYOUT_POPUP_HEIGHT 688
+#define LAYOUT_POPUP_ICON_WIDTH 460
+#define LAYOUT_POPUP_FONTSIZE 264
+#define LAYOUT_POPUP_LINE_1_Y 80
+#define LAYOUT_POPUP_LINE_2_Y 403
+#define LAYOUT_POPUP_ICON_X 230
+#define LAYOUT_POPUP_ICON_Y 345
+#define LAYOUT_POPUP_ICON_FONTSIZE 345
+#define LAYOUT_FONTSIZE_BORDER 230
+#define LAYOUT_FONTSIZE_MIN 172
+#define LAYOUT_FONTSIZE_DATE 322
+#define LAYOUT_TOPBAR_HEIGHT 352
+#define LAYOUT_NOWCAST_HEIGHT 64
+#define LAYOUT_RAIN_INDICATOR_HEIGHT 32
+#define LAYOUT_RAIN_BAR_SEP 23
+#define LAYOUT_RAIN_BAR_MAXHEIGHT 230
+#define LAYOUT_PROGRESS_HEIGHT 57
+#define LAYOUT_PROGRESS_OVERLAP 11
+#define LAYOUT_FONTSIZE_WIDGETS 311
+#define LAYOUT_WIDGETS_MARGIN_TOPBOTTOM 69
+#define LAYOUT_WIDGETS_MARGIN_LEFTRIGHT 92
+#define LAYOUT_WIDGETS_BOTTOM_PADDING 23
+#define LAYOUT_WIDGET_SEP 23
+#define LAYOUT_ICON_OFFSET 80
+#define LAYOUT_BAT_CENTER 241
+#define LAYOUT_STATUS_ICON_FONTSIZE 288
+#define LAYOUT_STATUS_ICON_Y 126
+#elif defined(PBL_PLATFORM_CHALK)
+#define LAYOUT_POPUP_HEIGHT 864
+#define LAYOUT_POPUP_ICON_WIDTH 576
+#define LAYOUT_POPUP_FONTSIZE 331
+#define LAYOUT_POPUP_LINE_1_Y 100
+#define LAYOUT_POPUP_LINE_2_Y 504
+#define LAYOUT_POPUP_ICON_X 288
+#define LAYOUT_POPUP_ICON_Y 432
+#define LAYOUT_POPUP_ICON_FONTSIZE 432
+#define LAYOUT_FONTSIZE_BORDER 288
+#define LAYOUT_FONTSIZE_MIN 216
+#define LAYOUT_FONTSIZE_DATE 403
+#define LAYOUT_TOPBAR_HEIGHT 448
+#define LAYOUT_NOWCAST_HEIGHT 80
+#define LAYOUT_RAIN_INDICATOR_HEIGHT 48
+#define LAYOUT_RAIN_BAR_SEP 28
+#define LAYOUT_RAIN_BAR_MAXHEIGHT 288
+#define LAYOUT_PROGRESS_HEIGHT 72
+#define LAYOUT_PROGRESS_OVERLAP 14
+#define LAYOUT_FONTSIZE_WIDGETS 388
+#define LAYOUT_WIDGETS_MARGIN_TOPBOTTOM 86
+#define LAYOUT_WIDGETS_MARGIN_LEFTRIGHT 115
+#define LAYOUT_WIDGETS_BOTTOM_PADDING 28
+#define LAYOUT_WIDGET_SEP 28
+#define LAYOUT_ICON_OFFSET 100
+#define LAYOUT_BAT_CENTER 302
+#define LAYOUT_STATUS_ICON_FONTSIZE 360
+#define LAYOUT_STATUS_ICON_Y 158
+#elif defined(PBL_PLATFORM_DIORITE)
+#define LAYOUT_POPUP_HEIGHT 688
+#define LAYOUT_POPUP_ICON_WIDTH 460
+#define LAYOUT_POPUP_FONTSIZE 264
+#define LAYOUT_POPUP_LINE_1_Y 80
+#define LAYOUT_POPUP_LINE_2_Y 403
+#define LAYOUT_POPUP_ICON_X 230
+#define LAYOUT_POPUP_ICON_Y 345
+#define LAYOUT_POPUP_ICON_FONTSIZE 345
+#define LAYOUT_FONTSIZE_BORDER 230
+#define LAYOUT_FONTSIZE_MIN 172
+#define LAYOUT_FONTSIZE_DATE 322
+#define LAYOUT_TOPBAR_HEIGHT 352
+#define LAYOUT_NOWCAST_HEIGHT 64
+#define LAYOUT_RAIN_INDICATOR_HEIGHT 32
+#define LAYOUT_RAIN_BAR_SEP 23
+#define LAYOUT_RAIN_BAR_MAXHEIGHT 230
+#define LAYOUT_PROGRESS_HEIGHT 57
+#define LAYOUT_PROGRESS_OVERLAP 11
+#define LAYOUT_FONTSIZE_WIDGETS 311
+#define LAYOUT_WIDGETS_MARGIN_TOPBOTTOM 69
+#define LAYOUT_WIDGETS_MARGIN_LEFTRIGHT 92
+#define LAYOUT_WIDGETS_BOTTOM_PADDING 23
+#define LAYOUT_WIDGET_SEP 23
+#define LAYOUT_ICON_OFFSET 80
+#define LAYOUT_BAT_CENTER 241
+#define LAYOUT_STATUS_ICON_FONTSIZE 288
+#define LAYOUT_STATUS_ICON_Y 126
+#elif defined(PBL_PLATFORM_EMERY)
+#define LAYOUT_POPUP_HEIGHT 960
+#define LAYOUT_POPUP_ICON_WIDTH 640
+#define LAYOUT_POPUP_FONTSIZE 368
+#define LAYOUT_POPUP_LINE_1_Y 112
+#define LAYOUT_POPUP_LINE_2_Y 560
+#define LAYOUT_POPUP_ICON_X 320
+#define LAYOUT_POPUP_ICON_Y 480
+#define LAYOUT_POPUP_ICON_FONTSIZE 480
+#define LAYOUT_FONTSIZE_BORDER 320
+#define LAYOUT_FONTSIZE_MIN 240
+#define LAYOUT_FONTSIZE_DATE 448
+#define LAYOUT_TOPBAR_HEIGHT 496
+#define LAYOUT_NOWCAST_HEIGHT 96
+#define LAYOUT_RAIN_INDICATOR_HEIGHT 48
+#define LAYOUT_RAIN_BAR_SEP 32
+#define LAYOUT_RAIN_BAR_MAXHEIGHT 320
+#define LAYOUT_PROGRESS_HEIGHT 80
+#define LAYOUT_PROGRESS_OVERLAP 16
+#define LAYOUT_FONTSIZE_WIDGETS 432
+#define LAYOUT_WIDGETS_MARGIN_TOPBOTTOM 96
+#define LAYOUT_WIDGETS_MARGIN_LEFTRIGHT 128
+#define LAYOUT_WIDGETS_BOTTOM_PADDING 32
+#define LAYOUT_WIDGET_SEP 32
+#define LAYOUT_ICON_OFFSET 112
+#define LAYOUT_BAT_CENTER 336
+#define LAYOUT_STATUS_ICON_FONTSIZE 400
+#define LAYOUT_STATUS_ICON_Y 176
+#else
+#error "no layout constants for this platform"
+#endif
+_Static_assert(LAYOUT_POPUP_HEIGHT == FIXED_ROUND(REM(60)), "LAYOUT_POPUP_HEIGHT does not match FIXED_ROUND(REM(60))");
+_Static_assert(LAYOUT_POPUP_ICON_WIDTH == REM(40), "LAYOUT_POPUP_ICON_WIDTH does not match REM(40)");
+_Static_assert(LAYOUT_POPUP_FONTSIZE == REM(23), "LAYOUT_POPUP_FONTSIZE does not match REM(23)");
+_Static_assert(LAYOUT_POPUP_LINE_1_Y == REM(7), "LAYOUT_POPUP_LINE_1_Y does not match REM(7)");
+_Static_assert(LAYOUT_POPUP_LINE_2_Y == REM(35), "LAYOUT_POPUP_LINE_2_Y does not match REM(35)");
+_Static_assert(LAYOUT_POPUP_ICON_X == REM(20), "LAYOUT_POPUP_ICON_X does not match REM(20)");
+_Static_assert(LAYOUT_POPUP_ICON_Y == REM(30), "LAYOUT_POPUP_ICON_Y does not match REM(30)");
+_Static_assert(LAYOUT_POPUP_ICON_FONTSIZE == REM(30), "LAYOUT_POPUP_ICON_FONTSIZE does not match REM(30)");
+_Static_assert(LAYOUT_FONTSIZE_BORDER == REM(20), "LAYOUT_FONTSIZE_BORDER does not match REM(20)");
+_Static_assert(LAYOUT_FONTSIZE_MIN == REM(15), "LAYOUT_FONTSIZE_MIN does not match REM(15)");
+_Static_assert(LAYOUT_FONTSIZE_DATE == REM(28), "LAYOUT_FONTSIZE_DATE does not match REM(28)");
+_Static_assert(LAYOUT_TOPBAR_HEIGHT == FIXED_ROUND(REM(27) + REM(4)), "LAYOUT_TOPBAR_HEIGHT does not match FIXED_ROUND(REM(27) + REM(4))");
+_Static_assert(LAYOUT_NOWCAST_HEIGHT == FIXED_ROUND(REM(6)), "LAYOUT_NOWCAST_HEIGHT does not match FIXED_ROUND(REM(6))");
+_Static_assert(LAYOUT_RAIN_INDICATOR_HEIGHT == FIXED_ROUND(REM(3)), "LAYOUT_RAIN_INDICATOR_HEIGHT does not match FIXED_ROUND(REM(3))");
+_Static_assert(LAYOUT_RAIN_BAR_SEP == REM(2), "LAYOUT_RAIN_BAR_SEP does not match REM(2)");
+_Static_assert(LAYOUT_RAIN_BAR_MAXHEIGHT == REM(20), "LAYOUT_RAIN_BAR_MAXHEIGHT does not match REM(20)");
+_Static_assert(LAYOUT_PROGRESS_HEIGHT == REM(5), "LAYOUT_PROGRESS_HEIGHT does not match REM(5)");
+_Static_assert(LAYOUT_PROGRESS_OVERLAP == REM(1), "LAYOUT_PROGRESS_OVERLAP does not match REM(1)");
+_Static_assert(LAYOUT_FONTSIZE_WIDGETS == REM(27), "LAYOUT_FONTSIZE_WIDGETS does not match REM(27)");
+_Static_assert(LAYOUT_WIDGETS_MARGIN_TOPBOTTOM == REM(6), "LAYOUT_WIDGETS_MARGIN_TOPBOTTOM does not match REM(6)");
+_Static_assert(LAYOUT_WIDGETS_MARGIN_LEFTRIGHT == REM(8), "LAYOUT_WIDGETS_MARGIN_LEFTRIGHT does not match REM(8)");
+_Static_assert(LAYOUT_WIDGETS_BOTTOM_PADDING == REM(2), "LAYOUT_WIDGETS_BOTTOM_PADDING does not match REM(2)");
+_Static_assert(LAYOUT_WIDGET_SEP == REM(2), "LAYOUT_WIDGET_SEP does not match REM(2)");
+_Static_assert(LAYOUT_ICON_OFFSET == REM(7), "LAYOUT_ICON_OFFSET does not match REM(7)");
+_Static_assert(LAYOUT_BAT_CENTER == REM(21), "LAYOUT_BAT_CENTER does not match REM(21)");
+_Static_assert(LAYOUT_STATUS_ICON_FONTSIZE == REM(25), "LAYOUT_STATUS_ICON_FONTSIZE does not match REM(25)");
+_Static_assert(LAYOUT_STATUS_ICON_Y == REM(11), "LAYOUT_STATUS_ICON_Y does not match REM(11)");
+// -- end autogen
+
 ////////////////////////////////////////////
 //// includes
 ////////////////////////////////////////////
 
+#include "scheduler.h"
+#include "fonts.h"
+#include "prerender.h"
 #include "settings.h"
 #include "ui-util.h"
 #include "ui.h"
@@ -1,3 +1,6 @@
+/** When this script was loaded, to measure how long it takes until the watch gets its first data. */
+var jsStartTime = (new Date()).getTime();
+
 function getPlatform() {
     if (Pebble.getActiveWatchInfo) {
         var watch = Pebble.getActiveWatchInfo();
@@ -32,21 +35,171 @@ function getUToken() {
     }
 }
 
+/** Hash of the configuration currently applied on the watch (as reported by the watch), or null if unknown. */
+var watchConfigHash = null;
+/**
+ * Configuration that is being sent to the watch, but has not been acknowledged with its new hash yet: the full
+ * configuration (config), the hash the watch had before (sentHash), and how often it was resent (resent).
+ */
+var pendingConfig = null;
+
+/** How often a configuration transfer the watch lost is resent. */
+var CONFIG_MAX_RESENDS = 2;
+
+/**
+ * The watch lost (part of) a configuration transfer and kept its old configuration: send the full configuration
+ * again, or give up (the next configuration change will send everything the watch hasn't acknowledged).
+ */
+function receivedConfigFailed() {
+    if (pendingConfig === null) return;
+    if (pendingConfig.resent >= CONFIG_MAX_RESENDS) {
+        pendingConfig = null;
+        return;
+    }
+    pendingConfig.resent += 1;
+    var resending = pendingConfig;
+    sendConfigPages(resending.config, function () {}, function () {
+        if (pendingConfig === resending) pendingConfig = null;
+    });
+}
+
+/**
+ * The configuration values that make up the hash of the watch, in the order the watch hashes them, with their
+ * size in bytes (0 for strings).
+ */
+var CONFIG_HASH_KEYS = [
+// -- autogen
+// -- ## for type, size in [("uint8_t", 1), ("uint16_t", 2), ("string", 0)]
+// -- ## for key in configuration
+// -- ##   if not key["local"] and key["type"] == type
+// --     ["{{ key["key"] }}", {{ size }}],
+// -- ##   endif
+// -- ## endfor
+// -- ## endfor
+    ["CONFIG_VIBRATE_DISCONNECT", 1],
+    ["CONFIG_VIBRATE_RECONNECT", 1],
+    ["CONFIG_MESSAGE_DISCONNECT", 1],
+    ["CONFIG_MESSAGE_RECONNECT", 1],
+    ["CONFIG_COLOR_TOPBAR_BG", 1],
+    ["CONFIG_COLOR_INFO_BELOW", 1],
+    ["CONFIG_COLOR_PROGRESS_BAR", 1],
+    ["CONFIG_COLOR_PROGRESS_BAR2", 1],
+    ["CONFIG_COLOR_TIME", 1],
+    ["CONFIG_COLOR_PERC", 1],
+    ["CONFIG_COLOR_WIDGET_1", 1],
+    ["CONFIG_COLOR_WIDGET_2", 1],
+    ["CONFIG_COLOR_WIDGET_3", 1],
+    ["CONFIG_COLOR_WIDGET_4", 1],
+    ["CONFIG_COLOR_WIDGET_5", 1],
+    ["CONFIG_COLOR_WIDGET_6", 1],
+    ["CONFIG_COLOR_BACKGROUND", 1],
+    ["CONFIG_COLOR_DAY", 1],
+    ["CONFIG_COLOR_NIGHT", 1],
+    ["CONFIG_COLOR_BAT_30", 1],
+    ["CONFIG_COLOR_BAT_20", 1],
+    ["CONFIG_COLOR_BAT_10", 1],
+    ["CONFIG_LOWBAT_COL", 1],
+    ["CONFIG_WIDGET_1", 1],
+    ["CONFIG_WIDGET_2", 1],
+    ["CONFIG_WIDGET_3", 1],
+    ["CONFIG_WIDGET_4", 1],
+    ["CONFIG_WIDGET_5", 1],
+    ["CONFIG_WIDGET_6", 1],
+    ["CONFIG_PROGRESS", 1],
+    ["CONFIG_UPDATE_SECOND", 1],
+    ["CONFIG_SHOW_DAYNIGHT", 1],
+    ["CONFIG_HOURLY_VIBRATE", 1],
+    ["CONFIG_WIDGET_7", 1],
+    ["CONFIG_WIDGET_8", 1],
+    ["CONFIG_WIDGET_9", 1],
+    ["CONFIG_WIDGET_10", 1],
+    ["CONFIG_WIDGET_11", 1],
+    ["CONFIG_WIDGET_12", 1],
+    ["CONFIG_2ND_WIDGETS", 1],
+    ["CONFIG_COLOR_QUIET_MODE", 1],
+    ["CONFIG_QUIET_COL", 1],
+    ["CONFIG_UPDATE_PHONEBAT_ON_SHAKE", 1],
+    ["CONFIG_PHONE_BATTERY_PUSH", 1],
+    ["CONFIG_PRERENDER_NEXT_MINUTE", 1],
+    ["CONFIG_POWER_SAVER", 1],
+    ["CONFIG_AMBIENT", 1],
+    ["CONFIG_WEATHER_REFRESH", 2],
+    ["CONFIG_WEATHER_EXPIRATION", 2],
+    ["CONFIG_WEATHER_REFRESH_FAILED", 2],
+    ["CONFIG_STEP_GOAL", 2],
+    ["CONFIG_TIMEOUT_2ND_WIDGETS", 2],
+    ["CONFIG_WEATHER_SUNRISE_EXPIRATION", 2],
+    ["CONFIG_PHONE_BATTERY_EXPIRATION", 2],
+    ["CONFIG_PHONE_BATTERY_REFRESH", 2],
+    ["CONFIG_TIME_FORMAT", 0],
+    ["CONFIG_INFO_BELOW", 0],
+    ["CONFIG_TZ_0_FORMAT", 0],
+    ["CONFIG_TZ_1_FORMAT", 0],
+    ["CONFIG_TZ_2_FORMAT", 0],
+    ["CONFIG_SUNRISE_FORMAT", 0],
+// -- end autogen
+];
+
+/**
+ * The hash the watch computes for a configuration (see compute_config_hash in src/settings.c), or null if the
+ * configuration doesn't contain all values.
+ */
+function computeConfigHash(config) {
+// -- autogen
+// --     var maxlen = {{ stringconfig_maxlen }};
+    var maxlen = 50;
+// -- end autogen
+    var hash = 2166136261;
+    var addByte = function (b) {
+        hash = Math.imul(hash ^ (b & 0xff), 16777619) >>> 0;
+    };
+    for (var i = 0; i < CONFIG_HASH_KEYS.length; i++) {
+        var value = config[CONFIG_HASH_KEYS[i][0]];
+        var size = CONFIG_HASH_KEYS[i][1];
+        if (value === undefined || value === null) return null;
+        if (size == 0) {
+            var bytes = unescape(encodeURIComponent(value)).substring(0, maxlen);
+            for (var j = 0; j < bytes.length; j++) addByte(bytes.charCodeAt(j));
+        } else {
+            for (var j = 0; j < size; j++) addByte(+value >> (8 * j));
+        }
+    }
+    return hash;
+}
+
+/** The configuration last acknowledged by the watch, if the watch still has exactly that configuration. */
+function readAckedConfig() {
+    var hash = localStorage.getItem("GRAPHITE_ACKED_CONFIG_HASH");
+    if (watchConfigHash === null || hash === null || +hash !== watchConfigHash) return null;
+    return JSON.parse(localStorage.getItem("GRAPHITE_ACKED_CONFIG"));
+}
+
+/** Called whenever the watch reports its configuration hash. */
+function receivedConfigHash(hash) {
+    hash = hash >>> 0;
+    watchConfigHash = hash;
+    if (pendingConfig === null) return;
+    // only a hash that belongs to the configuration we sent acknowledges it
+    var expected = computeConfigHash(pendingConfig.config);
+    if (expected === null ? hash === pendingConfig.sentHash : hash !== expected) return;
+    localStorage.setItem("GRAPHITE_ACKED_CONFIG", JSON.stringify(pendingConfig.config));
+    localStorage.setItem("GRAPHITE_ACKED_CONFIG_HASH", hash);
+    pendingConfig = null;
+}
+
 Pebble.addEventListener('ready', function () {
 // -- build=debug
-// --     console.log('[ info/app ] PebbleKit JS ready!');
-    console.log('[ info/app ] PebbleKit JS ready!');
+// --     console.log('[ info/app ] PebbleKit JS ready after ' + ((new Date()).getTime() - jsStartTime) + 'ms!');
+    console.log('[ info/app ] PebbleKit JS ready after ' + ((new Date()).getTime() - jsStartTime) + 'ms!');
 // -- end build
-    var data = {
-        "MSG_KEY_JS_READY": 1
-    };
-    Pebble.sendAppMessage(data);
+    loadConfig();
+    sendWarmStart();
 });
 
 Pebble.addEventListener('showConfiguration', function () {
 // -- autogen
 // --     var url = 'https://stefanheule.com/graphite/config/{{ config_version }}/index.html';
-    var url = 'https://stefanheule.com/graphite/config/3/index.html';
+    var url = 'https://stefanheule.com/graphite/config/4/index.html';
 // -- end autogen
 //     url = 'https://rawgit.com/stefanheule/graphite/master/config/';
 
@@ -83,6 +236,7 @@ Pebble.addEventListener('webviewclosed', function (e) {
     // decode config
     var config = {};
     var fullconfig = {};
+    var stored = {};
 // -- autogen
 // -- ## for key in configuration
 // --     fullconfig["{{ key["key"] }}"] = urlconfig[{{ key["id"] }}];
@@ -93,204 +247,223 @@ Pebble.addEventListener('webviewclosed', function (e) {
 // --     config["{{ key["key"] }}"] = +urlconfig[{{ key["id"] }}];
 // --   ## endif
 // -- ## endif
-// --     localStorage.setItem("{{ key["key"] }}", urlconfig[{{ key["id"] }}]);
+// --     stored["{{ key["key"] }}"] = urlconfig[{{ key["id"] }}];
 // -- ## endfor
     fullconfig["CONFIG_VIBRATE_DISCONNECT"] = urlconfig[1];
     config["CONFIG_VIBRATE_DISCONNECT"] = +urlconfig[1];
-    localStorage.setItem("CONFIG_VIBRATE_DISCONNECT", urlconfig[1]);
+    stored["CONFIG_VIBRATE_DISCONNECT"] = urlconfig[1];
     fullconfig["CONFIG_VIBRATE_RECONNECT"] = urlconfig[2];
     config["CONFIG_VIBRATE_RECONNECT"] = +urlconfig[2];
-    localStorage.setItem("CONFIG_VIBRATE_RECONNECT", urlconfig[2]);
+    stored["CONFIG_VIBRATE_RECONNECT"] = urlconfig[2];
     fullconfig["CONFIG_MESSAGE_DISCONNECT"] = urlconfig[3];
     config["CONFIG_MESSAGE_DISCONNECT"] = +urlconfig[3];
-    localStorage.setItem("CONFIG_MESSAGE_DISCONNECT", urlconfig[3]);
+    stored["CONFIG_MESSAGE_DISCONNECT"] = urlconfig[3];
     fullconfig["CONFIG_MESSAGE_RECONNECT"] = urlconfig[4];
     config["CONFIG_MESSAGE_RECONNECT"] = +urlconfig[4];
-    localStorage.setItem("CONFIG_MESSAGE_RECONNECT", urlconfig[4]);
+    stored["CONFIG_MESSAGE_RECONNECT"] = urlconfig[4];
     fullconfig["CONFIG_WEATHER_UNIT_LOCAL"] = urlconfig[5];
-    localStorage.setItem("CONFIG_WEATHER_UNIT_LOCAL", urlconfig[5]);
+    stored["CONFIG_WEATHER_UNIT_LOCAL"] = urlconfig[5];
     fullconfig["CONFIG_WEATHER_RAIN_LOCAL"] = urlconfig[6];
-    localStorage.setItem("CONFIG_WEATHER_RAIN_LOCAL", urlconfig[6]);
+    stored["CONFIG_WEATHER_RAIN_LOCAL"] = urlconfig[6];
     fullconfig["CONFIG_WEATHER_SOURCE_LOCAL"] = urlconfig[7];
-    localStorage.setItem("CONFIG_WEATHER_SOURCE_LOCAL", urlconfig[7]);
+    stored["CONFIG_WEATHER_SOURCE_LOCAL"] = urlconfig[7];
     fullconfig["CONFIG_WEATHER_APIKEY_LOCAL"] = urlconfig[8];
-    localStorage.setItem("CONFIG_WEATHER_APIKEY_LOCAL", urlconfig[8]);
+    stored["CONFIG_WEATHER_APIKEY_LOCAL"] = urlconfig[8];
     fullconfig["CONFIG_WEATHER_LOCATION_LOCAL"] = urlconfig[9];
-    localStorage.setItem("CONFIG_WEATHER_LOCATION_LOCAL", urlconfig[9]);
+    stored["CONFIG_WEATHER_LOCATION_LOCAL"] = urlconfig[9];
     fullconfig["CONFIG_WEATHER_REFRESH"] = urlconfig[10];
     config["CONFIG_WEATHER_REFRESH"] = +urlconfig[10];
-    localStorage.setItem("CONFIG_WEATHER_REFRESH", urlconfig[10]);
+    stored["CONFIG_WEATHER_REFRESH"] = urlconfig[10];
     fullconfig["CONFIG_WEATHER_EXPIRATION"] = urlconfig[11];
     config["CONFIG_WEATHER_EXPIRATION"] = +urlconfig[11];
-    localStorage.setItem("CONFIG_WEATHER_EXPIRATION", urlconfig[11]);
+    stored["CONFIG_WEATHER_EXPIRATION"] = urlconfig[11];
     fullconfig["CONFIG_WEATHER_REFRESH_FAILED"] = urlconfig[12];
     config["CONFIG_WEATHER_REFRESH_FAILED"] = +urlconfig[12];
-    localStorage.setItem("CONFIG_WEATHER_REFRESH_FAILED", urlconfig[12]);
+    stored["CONFIG_WEATHER_REFRESH_FAILED"] = urlconfig[12];
     fullconfig["CONFIG_COLOR_TOPBAR_BG"] = urlconfig[13];
     config["CONFIG_COLOR_TOPBAR_BG"] = +urlconfig[13];
-    localStorage.setItem("CONFIG_COLOR_TOPBAR_BG", urlconfig[13]);
+    stored["CONFIG_COLOR_TOPBAR_BG"] = urlconfig[13];
     fullconfig["CONFIG_COLOR_INFO_BELOW"] = urlconfig[14];
     config["CONFIG_COLOR_INFO_BELOW"] = +urlconfig[14];
-    localStorage.setItem("CONFIG_COLOR_INFO_BELOW", urlconfig[14]);
+    stored["CONFIG_COLOR_INFO_BELOW"] = urlconfig[14];
     fullconfig["CONFIG_COLOR_PROGRESS_BAR"] = urlconfig[15];
     config["CONFIG_COLOR_PROGRESS_BAR"] = +urlconfig[15];
-    localStorage.setItem("CONFIG_COLOR_PROGRESS_BAR", urlconfig[15]);
+    stored["CONFIG_COLOR_PROGRESS_BAR"] = urlconfig[15];
     fullconfig["CONFIG_COLOR_PROGRESS_BAR2"] = urlconfig[16];
     config["CONFIG_COLOR_PROGRESS_BAR2"] = +urlconfig[16];
-    localStorage.setItem("CONFIG_COLOR_PROGRESS_BAR2", urlconfig[16]);
+    stored["CONFIG_COLOR_PROGRESS_BAR2"] = urlconfig[16];
     fullconfig["CONFIG_COLOR_TIME"] = urlconfig[17];
     config["CONFIG_COLOR_TIME"] = +urlconfig[17];
-    localStorage.setItem("CONFIG_COLOR_TIME", urlconfig[17]);
+    stored["CONFIG_COLOR_TIME"] = urlconfig[17];
     fullconfig["CONFIG_COLOR_PERC"] = urlconfig[18];
     config["CONFIG_COLOR_PERC"] = +urlconfig[18];
-    localStorage.setItem("CONFIG_COLOR_PERC", urlconfig[18]);
+    stored["CONFIG_COLOR_PERC"] = urlconfig[18];
     fullconfig["CONFIG_COLOR_WIDGET_1"] = urlconfig[19];
     config["CONFIG_COLOR_WIDGET_1"] = +urlconfig[19];
-    localStorage.setItem("CONFIG_COLOR_WIDGET_1", urlconfig[19]);
+    stored["CONFIG_COLOR_WIDGET_1"] = urlconfig[19];
     fullconfig["CONFIG_COLOR_WIDGET_2"] = urlconfig[20];
     config["CONFIG_COLOR_WIDGET_2"] = +urlconfig[20];
-    localStorage.setItem("CONFIG_COLOR_WIDGET_2", urlconfig[20]);
+    stored["CONFIG_COLOR_WIDGET_2"] = urlconfig[20];
     fullconfig["CONFIG_COLOR_WIDGET_3"] = urlconfig[21];
     config["CONFIG_COLOR_WIDGET_3"] = +urlconfig[21];
-    localStorage.setItem("CONFIG_COLOR_WIDGET_3", urlconfig[21]);
+    stored["CONFIG_COLOR_WIDGET_3"] = urlconfig[21];
     fullconfig["CONFIG_COLOR_WIDGET_4"] = urlconfig[22];
     config["CONFIG_COLOR_WIDGET_4"] = +urlconfig[22];
-    localStorage.setItem("CONFIG_COLOR_WIDGET_4", urlconfig[22]);
+    stored["CONFIG_COLOR_WIDGET_4"] = urlconfig[22];
     fullconfig["CONFIG_COLOR_WIDGET_5"] = urlconfig[23];
     config["CONFIG_COLOR_WIDGET_5"] = +urlconfig[23];
-    localStorage.setItem("CONFIG_COLOR_WIDGET_5", urlconfig[23]);
+    stored["CONFIG_COLOR_WIDGET_5"] = urlconfig[23];
     fullconfig["CONFIG_COLOR_WIDGET_6"] = urlconfig[24];
     config["CONFIG_COLOR_WIDGET_6"] = +urlconfig[24];
-    localStorage.setItem("CONFIG_COLOR_WIDGET_6", urlconfig[24]);
+    stored["CONFIG_COLOR_WIDGET_6"] = urlconfig[24];
     fullconfig["CONFIG_COLOR_BACKGROUND"] = urlconfig[25];
     config["CONFIG_COLOR_BACKGROUND"] = +urlconfig[25];
-    localStorage.setItem("CONFIG_COLOR_BACKGROUND", urlconfig[25]);
+    stored["CONFIG_COLOR_BACKGROUND"] = urlconfig[25];
     fullconfig["CONFIG_COLOR_DAY"] = urlconfig[26];
     config["CONFIG_COLOR_DAY"] = +urlconfig[26];
-    localStorage.setItem("CONFIG_COLOR_DAY", urlconfig[26]);
+    stored["CONFIG_COLOR_DAY"] = urlconfig[26];
     fullconfig["CONFIG_COLOR_NIGHT"] = urlconfig[27];
     config["CONFIG_COLOR_NIGHT"] = +urlconfig[27];
-    localStorage.setItem("CONFIG_COLOR_NIGHT", urlconfig[27]);
+    stored["CONFIG_COLOR_NIGHT"] = urlconfig[27];
     fullconfig["CONFIG_COLOR_BAT_30"] = urlconfig[28];
     config["CONFIG_COLOR_BAT_30"] = +urlconfig[28];
-    localStorage.setItem("CONFIG_COLOR_BAT_30", urlconfig[28]);
+    stored["CONFIG_COLOR_BAT_30"] = urlconfig[28];
     fullconfig["CONFIG_COLOR_BAT_20"] = urlconfig[29];
     config["CONFIG_COLOR_BAT_20"] = +urlconfig[29];
-    localStorage.setItem("CONFIG_COLOR_BAT_20", urlconfig[29]);
+    stored["CONFIG_COLOR_BAT_20"] = urlconfig[29];
     fullconfig["CONFIG_COLOR_BAT_10"] = urlconfig[30];
     config["CONFIG_COLOR_BAT_10"] = +urlconfig[30];
-    localStorage.setItem("CONFIG_COLOR_BAT_10", urlconfig[30]);
+    stored["CONFIG_COLOR_BAT_10"] = urlconfig[30];
     fullconfig["CONFIG_LOWBAT_COL"] = urlconfig[31];
     config["CONFIG_LOWBAT_COL"] = +urlconfig[31];
-    localStorage.setItem("CONFIG_LOWBAT_COL", urlconfig[31]);
+    stored["CONFIG_LOWBAT_COL"] = urlconfig[31];
     fullconfig["CONFIG_ADVANCED_APPEARANCE_LOCAL"] = urlconfig[32];
-    localStorage.setItem("CONFIG_ADVANCED_APPEARANCE_LOCAL", urlconfig[32]);
+    stored["CONFIG_ADVANCED_APPEARANCE_LOCAL"] = urlconfig[32];
     fullconfig["CONFIG_WIDGET_1"] = urlconfig[33];
     config["CONFIG_WIDGET_1"] = +urlconfig[33];
-    localStorage.setItem("CONFIG_WIDGET_1", urlconfig[33]);
+    stored["CONFIG_WIDGET_1"] = urlconfig[33];
     fullconfig["CONFIG_WIDGET_2"] = urlconfig[34];
     config["CONFIG_WIDGET_2"] = +urlconfig[34];
-    localStorage.setItem("CONFIG_WIDGET_2", urlconfig[34]);
+    stored["CONFIG_WIDGET_2"] = urlconfig[34];
     fullconfig["CONFIG_WIDGET_3"] = urlconfig[35];
     config["CONFIG_WIDGET_3"] = +urlconfig[35];
-    localStorage.setItem("CONFIG_WIDGET_3", urlconfig[35]);
+    stored["CONFIG_WIDGET_3"] = urlconfig[35];
     fullconfig["CONFIG_WIDGET_4"] = urlconfig[36];
     config["CONFIG_WIDGET_4"] = +urlconfig[36];
-    localStorage.setItem("CONFIG_WIDGET_4", urlconfig[36]);
+    stored["CONFIG_WIDGET_4"] = urlconfig[36];
     fullconfig["CONFIG_WIDGET_5"] = urlconfig[37];
     config["CONFIG_WIDGET_5"] = +urlconfig[37];
-    localStorage.setItem("CONFIG_WIDGET_5", urlconfig[37]);
+    stored["CONFIG_WIDGET_5"] = urlconfig[37];
     fullconfig["CONFIG_WIDGET_6"] = urlconfig[38];
     config["CONFIG_WIDGET_6"] = +urlconfig[38];
-    localStorage.setItem("CONFIG_WIDGET_6", urlconfig[38]);
+    stored["CONFIG_WIDGET_6"] = urlconfig[38];
     fullconfig["CONFIG_PROGRESS"] = urlconfig[39];
     config["CONFIG_PROGRESS"] = +urlconfig[39];
-    localStorage.setItem("CONFIG_PROGRESS", urlconfig[39]);
+    stored["CONFIG_PROGRESS"] = urlconfig[39];
     fullconfig["CONFIG_TIME_FORMAT"] = urlconfig[40];
     config["CONFIG_TIME_FORMAT"] = urlconfig[40];
-    localStorage.setItem("CONFIG_TIME_FORMAT", urlconfig[40]);
+    stored["CONFIG_TIME_FORMAT"] = urlconfig[40];
     fullconfig["CONFIG_INFO_BELOW"] = urlconfig[41];
     config["CONFIG_INFO_BELOW"] = urlconfig[41];
-    localStorage.setItem("CONFIG_INFO_BELOW", urlconfig[41]);
+    stored["CONFIG_INFO_BELOW"] = urlconfig[41];
     fullconfig["CONFIG_UPDATE_SECOND"] = urlconfig[42];
     config["CONFIG_UPDATE_SECOND"] = +urlconfig[42];
-    localStorage.setItem("CONFIG_UPDATE_SECOND", urlconfig[42]);
+    stored["CONFIG_UPDATE_SECOND"] = urlconfig[42];
     fullconfig["CONFIG_ADVANCED_FORMAT_LOCAL"] = urlconfig[43];
-    localStorage.setItem("CONFIG_ADVANCED_FORMAT_LOCAL", urlconfig[43]);
+    stored["CONFIG_ADVANCED_FORMAT_LOCAL"] = urlconfig[43];
     fullconfig["CONFIG_TIME_FORMAT_LOCAL"] = urlconfig[44];
-    localStorage.setItem("CONFIG_TIME_FORMAT_LOCAL", urlconfig[44]);
+    stored["CONFIG_TIME_FORMAT_LOCAL"] = urlconfig[44];
     fullconfig["CONFIG_INFO_BELOW_LOCAL"] = urlconfig[45];
-    localStorage.setItem("CONFIG_INFO_BELOW_LOCAL", urlconfig[45]);
+    stored["CONFIG_INFO_BELOW_LOCAL"] = urlconfig[45];
     fullconfig["CONFIG_SHOW_DAYNIGHT"] = urlconfig[46];
     config["CONFIG_SHOW_DAYNIGHT"] = +urlconfig[46];
-    localStorage.setItem("CONFIG_SHOW_DAYNIGHT", urlconfig[46]);
+    stored["CONFIG_SHOW_DAYNIGHT"] = urlconfig[46];
     fullconfig["CONFIG_STEP_GOAL"] = urlconfig[47];
     config["CONFIG_STEP_GOAL"] = +urlconfig[47];
-    localStorage.setItem("CONFIG_STEP_GOAL", urlconfig[47]);
+    stored["CONFIG_STEP_GOAL"] = urlconfig[47];
     fullconfig["CONFIG_TZ_0_LOCAL"] = urlconfig[48];
-    localStorage.setItem("CONFIG_TZ_0_LOCAL", urlconfig[48]);
+    stored["CONFIG_TZ_0_LOCAL"] = urlconfig[48];
     fullconfig["CONFIG_TZ_1_LOCAL"] = urlconfig[49];
-    localStorage.setItem("CONFIG_TZ_1_LOCAL", urlconfig[49]);
+    stored["CONFIG_TZ_1_LOCAL"] = urlconfig[49];
     fullconfig["CONFIG_TZ_2_LOCAL"] = urlconfig[50];
-    localStorage.setItem("CONFIG_TZ_2_LOCAL", urlconfig[50]);
+    stored["CONFIG_TZ_2_LOCAL"] = urlconfig[50];
     fullconfig["CONFIG_TZ_0_FORMAT"] = urlconfig[51];
     config["CONFIG_TZ_0_FORMAT"] = urlconfig[51];
-    localStorage.setItem("CONFIG_TZ_0_FORMAT", urlconfig[51]);
+    stored["CONFIG_TZ_0_FORMAT"] = urlconfig[51];
     fullconfig["CONFIG_TZ_1_FORMAT"] = urlconfig[52];
     config["CONFIG_TZ_1_FORMAT"] = urlconfig[52];
-    localStorage.setItem("CONFIG_TZ_1_FORMAT", urlconfig[52]);
+    stored["CONFIG_TZ_1_FORMAT"] = urlconfig[52];
     fullconfig["CONFIG_TZ_2_FORMAT"] = urlconfig[53];
     config["CONFIG_TZ_2_FORMAT"] = urlconfig[53];
-    localStorage.setItem("CONFIG_TZ_2_FORMAT", urlconfig[53]);
+    stored["CONFIG_TZ_2_FORMAT"] = urlconfig[53];
     fullconfig["CONFIG_HOURLY_VIBRATE"] = urlconfig[54];
     config["CONFIG_HOURLY_VIBRATE"] = +urlconfig[54];
-    localStorage.setItem("CONFIG_HOURLY_VIBRATE", urlconfig[54]);
+    stored["CONFIG_HOURLY_VIBRATE"] = urlconfig[54];
     fullconfig["CONFIG_SUNRISE_FORMAT"] = urlconfig[55];
     config["CONFIG_SUNRISE_FORMAT"] = urlconfig[55];
-    localStorage.setItem("CONFIG_SUNRISE_FORMAT", urlconfig[55]);
+    stored["CONFIG_SUNRISE_FORMAT"] = urlconfig[55];
     fullconfig["CONFIG_WIDGET_7"] = urlconfig[56];
     config["CONFIG_WIDGET_7"] = +urlconfig[56];
-    localStorage.setItem("CONFIG_WIDGET_7", urlconfig[56]);
+    stored["CONFIG_WIDGET_7"] = urlconfig[56];
     fullconfig["CONFIG_WIDGET_8"] = urlconfig[57];
     config["CONFIG_WIDGET_8"] = +urlconfig[57];
-    localStorage.setItem("CONFIG_WIDGET_8", urlconfig[57]);
+    stored["CONFIG_WIDGET_8"] = urlconfig[57];
     fullconfig["CONFIG_WIDGET_9"] = urlconfig[58];
     config["CONFIG_WIDGET_9"] = +urlconfig[58];
-    localStorage.setItem("CONFIG_WIDGET_9", urlconfig[58]);
+    stored["CONFIG_WIDGET_9"] = urlconfig[58];
     fullconfig["CONFIG_WIDGET_10"] = urlconfig[59];
     config["CONFIG_WIDGET_10"] = +urlconfig[59];
-    localStorage.setItem("CONFIG_WIDGET_10", urlconfig[59]);
+    stored["CONFIG_WIDGET_10"] = urlconfig[59];
     fullconfig["CONFIG_WIDGET_11"] = urlconfig[60];
     config["CONFIG_WIDGET_11"] = +urlconfig[60];
-    localStorage.setItem("CONFIG_WIDGET_11", urlconfig[60]);
+    stored["CONFIG_WIDGET_11"] = urlconfig[60];
     fullconfig["CONFIG_WIDGET_12"] = urlconfig[61];
     config["CONFIG_WIDGET_12"] = +urlconfig[61];
-    localStorage.setItem("CONFIG_WIDGET_12", urlconfig[61]);
+    stored["CONFIG_WIDGET_12"] = urlconfig[61];
     fullconfig["CONFIG_TIMEOUT_2ND_WIDGETS"] = urlconfig[62];
     config["CONFIG_TIMEOUT_2ND_WIDGETS"] = +urlconfig[62];
-    localStorage.setItem("CONFIG_TIMEOUT_2ND_WIDGETS", urlconfig[62]);
+    stored["CONFIG_TIMEOUT_2ND_WIDGETS"] = urlconfig[62];
     fullconfig["CONFIG_2ND_WIDGETS"] = urlconfig[63];
     config["CONFIG_2ND_WIDGETS"] = +urlconfig[63];
-    localStorage.setItem("CONFIG_2ND_WIDGETS", urlconfig[63]);
+    stored["CONFIG_2ND_WIDGETS"] = urlconfig[63];
     fullconfig["CONFIG_WEATHER_SUNRISE_EXPIRATION"] = urlconfig[64];
     config["CONFIG_WEATHER_SUNRISE_EXPIRATION"] = +urlconfig[64];
-    localStorage.setItem("CONFIG_WEATHER_SUNRISE_EXPIRATION", urlconfig[64]);
+    stored["CONFIG_WEATHER_SUNRISE_EXPIRATION"] = urlconfig[64];
     fullconfig["CONFIG_COLOR_QUIET_MODE"] = urlconfig[65];
     config["CONFIG_COLOR_QUIET_MODE"] = +urlconfig[65];
-    localStorage.setItem("CONFIG_COLOR_QUIET_MODE", urlconfig[65]);
+    stored["CONFIG_COLOR_QUIET_MODE"] = urlconfig[65];
     fullconfig["CONFIG_QUIET_COL"] = urlconfig[66];
     config["CONFIG_QUIET_COL"] = +urlconfig[66];
-    localStorage.setItem("CONFIG_QUIET_COL", urlconfig[66]);
+    stored["CONFIG_QUIET_COL"] = urlconfig[66];
     fullconfig["CONFIG_PHONE_BATTERY_EXPIRATION"] = urlconfig[67];
     config["CONFIG_PHONE_BATTERY_EXPIRATION"] = +urlconfig[67];
-    localStorage.setItem("CONFIG_PHONE_BATTERY_EXPIRATION", urlconfig[67]);
+    stored["CONFIG_PHONE_BATTERY_EXPIRATION"] = urlconfig[67];
     fullconfig["CONFIG_PHONE_BATTERY_REFRESH"] = urlconfig[68];
     config["CONFIG_PHONE_BATTERY_REFRESH"] = +urlconfig[68];
-    localStorage.setItem("CONFIG_PHONE_BATTERY_REFRESH", urlconfig[68]);
+    stored["CONFIG_PHONE_BATTERY_REFRESH"] = urlconfig[68];
     fullconfig["CONFIG_UPDATE_PHONEBAT_ON_SHAKE"] = urlconfig[69];
     config["CONFIG_UPDATE_PHONEBAT_ON_SHAKE"] = +urlconfig[69];
-    localStorage.setItem("CONFIG_UPDATE_PHONEBAT_ON_SHAKE", urlconfig[69]);
+    stored["CONFIG_UPDATE_PHONEBAT_ON_SHAKE"] = urlconfig[69];
+    fullconfig["CONFIG_PHONE_BATTERY_PUSH"] = urlconfig[70];
+    config["CONFIG_PHONE_BATTERY_PUSH"] = +urlconfig[70];
+    stored["CONFIG_PHONE_BATTERY_PUSH"] = urlconfig[70];
+    fullconfig["CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL"] = urlconfig[71];
+    stored["CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL"] = urlconfig[71];
+    fullconfig["CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL"] = urlconfig[72];
+    stored["CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL"] = urlconfig[72];
+    fullconfig["CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL"] = urlconfig[73];
+    stored["CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL"] = urlconfig[73];
+    fullconfig["CONFIG_PRERENDER_NEXT_MINUTE"] = urlconfig[74];
+    config["CONFIG_PRERENDER_NEXT_MINUTE"] = +urlconfig[74];
+    stored["CONFIG_PRERENDER_NEXT_MINUTE"] = urlconfig[74];
+    fullconfig["CONFIG_POWER_SAVER"] = urlconfig[75];
+    config["CONFIG_POWER_SAVER"] = +urlconfig[75];
+    stored["CONFIG_POWER_SAVER"] = urlconfig[75];
+    fullconfig["CONFIG_AMBIENT"] = urlconfig[76];
+    config["CONFIG_AMBIENT"] = +urlconfig[76];
+    stored["CONFIG_AMBIENT"] = urlconfig[76];
 // -- end autogen
+    writeConfig(stored);
 
     // don't allow really small values for refresh rate
     if (config["CONFIG_WEATHER_REFRESH"] < 10) {
@@ -308,11 +481,11 @@ Pebble.addEventListener('webviewclosed', function (e) {
 
 // -- autogen
 // -- ## for i in range(num_tzs)
-// --     if (has_widget([{{ widgets_lookup["WIDGET_TZ_" + i|string]["id"] }}])) sendTzUpdate({{ i }});
+// --     if (need_tz({{ i }})) sendTzUpdate({{ i }});
 // -- ## endfor
-    if (has_widget([34])) sendTzUpdate(0);
-    if (has_widget([35])) sendTzUpdate(1);
-    if (has_widget([36])) sendTzUpdate(2);
+    if (need_tz(0)) sendTzUpdate(0);
+    if (need_tz(1)) sendTzUpdate(1);
+    if (need_tz(2)) sendTzUpdate(2);
 // -- end autogen
 
     // remove config data that we don't need
@@ -341,28 +514,238 @@ Pebble.addEventListener('webviewclosed', function (e) {
     if (!(readConfig("CONFIG_2ND_WIDGETS"))) delete config["CONFIG_TIMEOUT_2ND_WIDGETS"];
     if (!(readConfig("CONFIG_QUIET_COL") != 0)) delete config["CONFIG_COLOR_QUIET_MODE"];
     if (!(has_widget([43, 44, 45, 46, 47, 48, 49, 50, 51]))) delete config["CONFIG_PHONE_BATTERY_EXPIRATION"];
-    if (!(has_widget([43, 44, 45, 46, 47, 48, 49, 50, 51]))) delete config["CONFIG_PHONE_BATTERY_REFRESH"];
-    if (!(has_widget([43, 44, 45, 46, 47, 48, 49, 50, 51]))) delete config["CONFIG_UPDATE_PHONEBAT_ON_SHAKE"];
+    if (!(has_widget([43, 44, 45, 46, 47, 48, 49, 50, 51]) && readConfig("CONFIG_PHONE_BATTERY_PUSH") == 0)) delete config["CONFIG_PHONE_BATTERY_REFRESH"];
+    if (!(has_widget([43, 44, 45, 46, 47, 48, 49, 50, 51]) && readConfig("CONFIG_PHONE_BATTERY_PUSH") == 0)) delete config["CONFIG_UPDATE_PHONEBAT_ON_SHAKE"];
+    if (!(has_widget([43, 44, 45, 46, 47, 48, 49, 50, 51]))) delete config["CONFIG_PHONE_BATTERY_PUSH"];
+    if (!(has_widget([43, 44, 45, 46, 47, 48, 49, 50, 51]) && readConfig("CONFIG_PHONE_BATTERY_PUSH") != 0)) delete config["CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL"];
+    if (!(readConfig("CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL") > 1)) delete config["CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL"];
+    if (!(readConfig("CONFIG_UPDATE_SECOND") == 0)) delete config["CONFIG_PRERENDER_NEXT_MINUTE"];
 // -- end autogen
 
-    Pebble.sendAppMessage(config, function () {
+    // only send what changed compared to the configuration the watch has acknowledged
+    var acked = readAckedConfig();
+    var merged = {};
+    var delta = {};
+    var ndelta = 0;
+    for (var key in acked) {
+        merged[key] = acked[key];
+    }
+    for (var key in config) {
+        if (acked === null || acked[key] !== config[key]) {
+            delta[key] = config[key];
+            ndelta += 1;
+        }
+        merged[key] = config[key];
+    }
+    if (ndelta == 0) {
 // -- build=debug
-// --         console.log('[ info/app ] Send successful: ' + JSON.stringify(config));
-        console.log('[ info/app ] Send successful: ' + JSON.stringify(config));
+// --         console.log('[ info/app ] Configuration unchanged, nothing to send.');
+        console.log('[ info/app ] Configuration unchanged, nothing to send.');
 // -- end build
-    }, function(e) {
+        return;
+    }
+
+    // the watch will acknowledge with its new configuration hash (which may arrive before the send callback)
+    var pending = {config: merged, sentHash: watchConfigHash, resent: 0};
+    pendingConfig = pending;
+    sendConfigPages(delta, function () {
+        subscribeBattery();
 // -- build=debug
-// --         console.log(JSON.stringify(config));
-// --         console.log('Message failed: ' + JSON.stringify(e));
-        console.log(JSON.stringify(config));
-        console.log('Message failed: ' + JSON.stringify(e));
+// --         console.log('[ info/app ] Send successful: ' + JSON.stringify(delta));
+        console.log('[ info/app ] Send successful: ' + JSON.stringify(delta));
 // -- end build
+    }, function () {
+        // the watch never got the whole configuration, so there is nothing to acknowledge
+        if (pendingConfig === pending) pendingConfig = null;
     });
 });
 
+/** Number of bytes a value occupies in an AppMessage (numbers are sent as 32 bit integers). */
+function appMessageValueSize(value) {
+    if (typeof value === "string") {
+        return unescape(encodeURIComponent(value)).length + 1;
+    }
+    return 4;
+}
+
+/**
+ * Send configuration to the watch in pages of bounded size, one after the other.  The watch only
+ * applies the configuration once the last page has arrived.  If a page can't be delivered, fail is called.
+ */
+function sendConfigPages(config, succ, fail) {
+// -- autogen
+// --     var max_page_size = {{ config_page_size }};
+    var max_page_size = 256;
+// -- end autogen
+    // dictionary header, plus the page number and last page marker
+    var page_overhead = 1 + 2 * (7 + 4);
+    var pages = [];
+    var page = {};
+    var size = page_overhead;
+    for (var key in config) {
+        var tuple_size = 7 + appMessageValueSize(config[key]);
+        if (size + tuple_size > max_page_size && size > page_overhead) {
+            pages.push(page);
+            page = {};
+            size = page_overhead;
+        }
+        page[key] = config[key];
+        size += tuple_size;
+    }
+    pages.push(page);
+    pages[pages.length - 1]["MSG_KEY_CONFIG_LAST"] = 1;
+
+    var retries = 0;
+    var sendPage = function (i) {
+        pages[i]["MSG_KEY_CONFIG_PAGE"] = i;
+        Pebble.sendAppMessage(pages[i], function () {
+            retries = 0;
+            if (i + 1 < pages.length) {
+                sendPage(i + 1);
+            } else {
+                succ();
+            }
+        }, function (e) {
+// -- build=debug
+// --             console.log(JSON.stringify(pages[i]));
+// --             console.log('Message failed: ' + JSON.stringify(e));
+            console.log(JSON.stringify(pages[i]));
+            console.log('Message failed: ' + JSON.stringify(e));
+// -- end build
+            retries += 1;
+            if (retries <= 3) {
+                sendPage(i);
+            } else {
+                fail();
+            }
+        });
+    };
+    sendPage(0);
+}
+
+/** The configuration stored on the phone (all values as strings), see loadConfig. */
+var storedConfig = null;
+/** Flags derived from the configuration, recomputed only when the configuration changes. */
+var derivedConfig = null;
+
+/**
+ * Load the configuration from its single localStorage entry.  Older versions stored every key separately, those
+ * are migrated once.
+ */
+function loadConfig() {
+    if (storedConfig !== null) return;
+    storedConfig = JSON.parse(localStorage.getItem("GRAPHITE_CONFIG") || "null");
+    if (storedConfig !== null) return;
+    storedConfig = {};
+    var keys = [
+// -- autogen
+// -- ## for key in configuration
+// --         "{{ key["key"] }}",
+// -- ## endfor
+        "CONFIG_VIBRATE_DISCONNECT",
+        "CONFIG_VIBRATE_RECONNECT",
+        "CONFIG_MESSAGE_DISCONNECT",
+        "CONFIG_MESSAGE_RECONNECT",
+        "CONFIG_WEATHER_UNIT_LOCAL",
+        "CONFIG_WEATHER_RAIN_LOCAL",
+        "CONFIG_WEATHER_SOURCE_LOCAL",
+        "CONFIG_WEATHER_APIKEY_LOCAL",
+        "CONFIG_WEATHER_LOCATION_LOCAL",
+        "CONFIG_WEATHER_REFRESH",
+        "CONFIG_WEATHER_EXPIRATION",
+        "CONFIG_WEATHER_REFRESH_FAILED",
+        "CONFIG_COLOR_TOPBAR_BG",
+        "CONFIG_COLOR_INFO_BELOW",
+        "CONFIG_COLOR_PROGRESS_BAR",
+        "CONFIG_COLOR_PROGRESS_BAR2",
+        "CONFIG_COLOR_TIME",
+        "CONFIG_COLOR_PERC",
+        "CONFIG_COLOR_WIDGET_1",
+        "CONFIG_COLOR_WIDGET_2",
+        "CONFIG_COLOR_WIDGET_3",
+        "CONFIG_COLOR_WIDGET_4",
+        "CONFIG_COLOR_WIDGET_5",
+        "CONFIG_COLOR_WIDGET_6",
+        "CONFIG_COLOR_BACKGROUND",
+        "CONFIG_COLOR_DAY",
+        "CONFIG_COLOR_NIGHT",
+        "CONFIG_COLOR_BAT_30",
+        "CONFIG_COLOR_BAT_20",
+        "CONFIG_COLOR_BAT_10",
+        "CONFIG_LOWBAT_COL",
+        "CONFIG_ADVANCED_APPEARANCE_LOCAL",
+        "CONFIG_WIDGET_1",
+        "CONFIG_WIDGET_2",
+        "CONFIG_WIDGET_3",
+        "CONFIG_WIDGET_4",
+        "CONFIG_WIDGET_5",
+        "CONFIG_WIDGET_6",
+        "CONFIG_PROGRESS",
+        "CONFIG_TIME_FORMAT",
+        "CONFIG_INFO_BELOW",
+        "CONFIG_UPDATE_SECOND",
+        "CONFIG_ADVANCED_FORMAT_LOCAL",
+        "CONFIG_TIME_FORMAT_LOCAL",
+        "CONFIG_INFO_BELOW_LOCAL",
+        "CONFIG_SHOW_DAYNIGHT",
+        "CONFIG_STEP_GOAL",
+        "CONFIG_TZ_0_LOCAL",
+        "CONFIG_TZ_1_LOCAL",
+        "CONFIG_TZ_2_LOCAL",
+        "CONFIG_TZ_0_FORMAT",
+        "CONFIG_TZ_1_FORMAT",
+        "CONFIG_TZ_2_FORMAT",
+        "CONFIG_HOURLY_VIBRATE",
+        "CONFIG_SUNRISE_FORMAT",
+        "CONFIG_WIDGET_7",
+        "CONFIG_WIDGET_8",
+        "CONFIG_WIDGET_9",
+        "CONFIG_WIDGET_10",
+        "CONFIG_WIDGET_11",
+        "CONFIG_WIDGET_12",
+        "CONFIG_TIMEOUT_2ND_WIDGETS",
+        "CONFIG_2ND_WIDGETS",
+        "CONFIG_WEATHER_SUNRISE_EXPIRATION",
+        "CONFIG_COLOR_QUIET_MODE",
+        "CONFIG_QUIET_COL",
+        "CONFIG_PHONE_BATTERY_EXPIRATION",
+        "CONFIG_PHONE_BATTERY_REFRESH",
+        "CONFIG_UPDATE_PHONEBAT_ON_SHAKE",
+        "CONFIG_PHONE_BATTERY_PUSH",
+        "CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL",
+        "CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL",
+        "CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL",
+        "CONFIG_PRERENDER_NEXT_MINUTE",
+        "CONFIG_POWER_SAVER",
+        "CONFIG_AMBIENT",
+// -- end autogen
+    ];
+    var migrated = false;
+    for (var i = 0; i < keys.length; i++) {
+        var value = localStorage.getItem(keys[i]);
+        if (value === null) continue;
+        storedConfig[keys[i]] = value;
+        localStorage.removeItem(keys[i]);
+        migrated = true;
+    }
+    if (migrated) localStorage.setItem("GRAPHITE_CONFIG", JSON.stringify(storedConfig));
+}
+
+/** Update several configuration elements at once, with a single localStorage write. */
+function writeConfig(values) {
+    loadConfig();
+    for (var key in values) {
+        // keep the semantics of storing every key in localStorage, which only holds strings
+        storedConfig[key] = String(values[key]);
+    }
+    localStorage.setItem("GRAPHITE_CONFIG", JSON.stringify(storedConfig));
+    derivedConfig = null;
+}
+
 /** Read a configuration element (handles defaults) */
 function readConfig(key) {
-    var res = localStorage.getItem(key);
+    loadConfig();
+    var res = storedConfig.hasOwnProperty(key) ? storedConfig[key] : null;
     if (res === null) {
         if (false) {
             // do nothing
@@ -397,6 +780,12 @@ function readConfig(key) {
             return "America/Los_Angeles";
         } else if (key == "CONFIG_TZ_2_LOCAL") {
             return "America/Los_Angeles";
+        } else if (key == "CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL") {
+            return 5;
+        } else if (key == "CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL") {
+            return 0;
+        } else if (key == "CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL") {
+            return "";
 // -- end autogen
         }
     }
@@ -496,7 +885,7 @@ function failedWeatherCheck(err) {
     Pebble.sendAppMessage(data);
 }
 
-function concurrentRequests(urls, succ) {
+function concurrentRequests(urls, succ, fail) {
     var i = 0;
     var n = urls.length;
     var ids = urls.map(function() { i = i+1; return i-1; });
@@ -504,11 +893,19 @@ function concurrentRequests(urls, succ) {
     var doneCount = 0;
     var answers = ids.map(function() { return false });
     var reqs;
+    var finished = false;
     var quit = function() {
         for (var i = 0; i < n; i++) {
             if (!done[i]) reqs[i].abort();
         }
     }
+    var failed = function(err) {
+        if (finished) return;
+        finished = true;
+        clearTimeout(myTimeout);
+        quit();
+        fail(err);
+    }
     reqs = ids.map(function(i){
         var url = urls[i];
         if (url === undefined) {
@@ -528,29 +925,40 @@ function concurrentRequests(urls, succ) {
                     answers[i] = JSON.parse(req.responseText);
                     done[i] = true;
                     doneCount += 1;
-                    if (doneCount == n) {
+                    if (doneCount == n && !finished) {
+                        finished = true;
+                        clearTimeout(myTimeout);
                         try {
                             succ(answers);
                         } catch (e) {
-                            failedWeatherCheck("exception: " + e)
+                            fail("exception: " + e)
                         }
-                        clearTimeout(myTimeout);
                     }
                 } else {
-                    quit();
-                    failedWeatherCheck("non-200 status: " + req.status + " / " + req.statusText)
+                    failed("non-200 status: " + req.status + " / " + req.statusText)
                 }
             }
         };
+        req.onerror = function () {
+            failed("network error");
+        };
         req.send(null);
         return req;
     });
 
     // try for 30 seconds to get weather, then time out
     var myTimeout = setTimeout(function(){
-        failedWeatherCheck("timeout");
-        quit();
+        failed("timeout");
     }, 30000);
+
+    return {
+        abort: function() {
+            if (finished) return;
+            finished = true;
+            clearTimeout(myTimeout);
+            quit();
+        }
+    };
 }
 
 function has_widget(ids) {
@@ -562,7 +970,37 @@ function has_widget(ids) {
     return false;
 }
 
+/** Flags derived from the configuration (the weather parts and time zones that are needed). */
+function readDerivedConfig() {
+    if (derivedConfig === null) {
+        derivedConfig = {
+            weather: computeNeedWeather(),
+// -- autogen
+// --             phonebat: {{ config_groups_lookup["GROUP_PHONEBAT"]["selector"] }},
+            phonebat: has_widget([43, 44, 45, 46, 47, 48, 49, 50, 51]),
+// -- end autogen
+// -- autogen
+// --             tz: [{% for i in range(num_tzs) %}has_widget([{{ widgets_lookup["WIDGET_TZ_" + i|string]["id"] }}]){% if not loop.last %}, {% endif %}{% endfor %}]
+            tz: [has_widget([34]), has_widget([35]), has_widget([36])]
+// -- end autogen
+        };
+    }
+    return derivedConfig;
+}
+
 function need_weather() {
+    return readDerivedConfig().weather;
+}
+
+function need_phonebat() {
+    return readDerivedConfig().phonebat;
+}
+
+function need_tz(idx) {
+    return readDerivedConfig().tz[idx];
+}
+
+function computeNeedWeather() {
     var load_rain = +readConfig("CONFIG_WEATHER_RAIN_LOCAL");
 // -- autogen
 // --     var load_lowhigh = {{ config_groups_lookup["GROUP_WEATHERLOWHIGH"]["selector"] }};
@@ -575,183 +1013,568 @@ function need_weather() {
     return [load_rain || load_lowhigh || load_cur || load_sun, load_rain, load_lowhigh, load_cur, load_sun];
 }
 
-function fetchWeather(latitude, longitude) {
-
-    var now = new Date();
+/**
+ * Send weather conditions (as determined by requestWeather) to the watch.  For cached conditions, age is how many
+ * seconds ago they were fetched (sent like MSG_KEY_WARM_START), so the watch keeps the original fetch time.
+ */
+function sendWeather(result, nw, age) {
+    var data = {};
+    var acked = packWeather(result, nw, data);
+    if (age !== undefined) {
+        var tags = encode_int_to_bytes(age, 4);
+        Array.prototype.push.apply(tags, encode_int_to_bytes(0xffffffff, 4));
+        data["MSG_KEY_WARM_START"] = tags;
+    }
+    Pebble.sendAppMessage(data, function () {
+        // the watch now has this precipitation series, future updates can be sent relative to it
+        localStorage.setItem("GRAPHITE_ACKED_RAIN", JSON.stringify(acked));
+    }, function () {
+        localStorage.removeItem("GRAPHITE_ACKED_RAIN");
+    });
+}
 
-    var nw = need_weather();
+/**
+ * Add weather conditions (as determined by requestWeather) to an AppMessage.  Returns the precipitation series
+ * to remember once the watch acknowledged the message.
+ */
+function packWeather(result, nw, data) {
     var load_rain = nw[1];
-    var load_lowhigh = nw[2];
-    var load_cur = nw[3];
     var load_sun = nw[4];
-
-    /** Callback on successful determination of weather conditions. */
-    var success = function(low, high, cur, curicon, raindata, ts, sunrise, sunset) {
-        if (+readConfig("CONFIG_WEATHER_UNIT_LOCAL") == 2) {
-            if (low != temp_unknown) low = low * 9.0/5.0 + 32.0;
-            if (high != temp_unknown) high = high * 9.0/5.0 + 32.0;
-            if (cur != temp_unknown) cur = cur * 9.0/5.0 + 32.0;
-        }
-        low = Math.round(low);
-        high = Math.round(high);
-        cur = Math.round(cur);
-        if (!curicon) {
-            curicon = "a";
-        }
+    var temp_unknown = 32767;
+    var low = result.low;
+    var high = result.high;
+    var cur = result.cur;
+    var curicon = result.icon;
+    var raindata = result.raindata;
+    var ts = result.ts;
+    var sunrise = result.sunrise;
+    var sunset = result.sunset;
+    if (+readConfig("CONFIG_WEATHER_UNIT_LOCAL") == 2) {
+        if (low != temp_unknown) low = low * 9.0/5.0 + 32.0;
+        if (high != temp_unknown) high = high * 9.0/5.0 + 32.0;
+        if (cur != temp_unknown) cur = cur * 9.0/5.0 + 32.0;
+    }
+    low = Math.round(low);
+    high = Math.round(high);
+    cur = Math.round(cur);
+    if (!curicon) {
+        curicon = "a";
+    }
 // -- autogen
-// --         if (raindata.length > {{ perc_max_len }}) raindata = raindata.slice(0, {{ perc_max_len }});
-        if (raindata.length > 30) raindata = raindata.slice(0, 30);
+// --     if (raindata.length > {{ perc_max_len }}) raindata = raindata.slice(0, {{ perc_max_len }});
+    if (raindata.length > 30) raindata = raindata.slice(0, 30);
 // -- end autogen
 
-        var icon = curicon.charCodeAt(0);
-        var data = {
-            "MSG_KEY_WEATHER_ICON_CUR": icon,
-            "MSG_KEY_WEATHER_TEMP_CUR": cur,
-            "MSG_KEY_WEATHER_TEMP_LOW": low,
-            "MSG_KEY_WEATHER_TEMP_HIGH": high
-        };
-        if (load_rain) {
-            data["MSG_KEY_WEATHER_PERC_DATA"] = raindata;
-            data["MSG_KEY_WEATHER_PERC_DATA_LEN"] = raindata.length;
-            data["MSG_KEY_WEATHER_PERC_DATA_TS"] = ts;
-        }
-        if (load_sun) {
-            data["MSG_KEY_WEATHER_SUNRISE"] = sunrise;
-            data["MSG_KEY_WEATHER_SUNSET"] = sunset;
+    if (!load_rain) {
+        raindata = [];
+        ts = 0;
+    }
+    if (!load_sun) {
+        sunrise = 0;
+        sunset = 0;
+    }
+
+    // pack everything into a single binary record, see weather_payload_* in scripts/initialize.py
+    var icon = curicon.charCodeAt(0);
+    var delta = load_rain ? rainDelta(ts, raindata) : null;
+    var payload = [];
+// -- autogen
+// --     payload.push(delta === null ? {{ weather_payload_version }} : {{ weather_payload_delta_version }});
+    payload.push(delta === null ? 1 : 2);
+// -- end autogen
+    payload.push(icon);
+    Array.prototype.push.apply(payload, encode_int_to_bytes(cur, 2));
+    Array.prototype.push.apply(payload, encode_int_to_bytes(low, 2));
+    Array.prototype.push.apply(payload, encode_int_to_bytes(high, 2));
+    Array.prototype.push.apply(payload, encode_int_to_bytes(sunrise, 4));
+    Array.prototype.push.apply(payload, encode_int_to_bytes(sunset, 4));
+    Array.prototype.push.apply(payload, encode_int_to_bytes(ts, 4));
+    payload.push(raindata.length);
+    Array.prototype.push.apply(payload, delta === null ? raindata : delta);
+    data["MSG_KEY_WEATHER"] = payload;
+    if (load_rain && result.nowcast) {
+        // start (4), number of minutes (1), then two 4-bit levels per byte
+        var nowcast = encode_int_to_bytes(result.nowcast.ts, 4);
+        nowcast.push(result.nowcast.data.length);
+        for (var i = 0; i < result.nowcast.data.length; i += 2) {
+            nowcast.push(result.nowcast.data[i] | ((result.nowcast.data[i + 1] || 0) << 4));
         }
+        data["MSG_KEY_NOWCAST"] = nowcast;
+    }
 // -- build=debug
-// --         console.log('[ info/app ] weather send: temp=' + low + "/" + cur + "/" + high + ", icon=" + String.fromCharCode(icon) + ", len(rain)=" + raindata.length + ", ts=" + ts + ", sunrise=" + sunrise + ".");
-        console.log('[ info/app ] weather send: temp=' + low + "/" + cur + "/" + high + ", icon=" + String.fromCharCode(icon) + ", len(rain)=" + raindata.length + ", ts=" + ts + ", sunrise=" + sunrise + ".");
+// --     console.log('[ info/app ] weather send: temp=' + low + "/" + cur + "/" + high + ", icon=" + String.fromCharCode(icon) + ", len(rain)=" + raindata.length + ", ts=" + ts + ", sunrise=" + sunrise + ", " + ((new Date()).getTime() - jsStartTime) + "ms after start.");
+    console.log('[ info/app ] weather send: temp=' + low + "/" + cur + "/" + high + ", icon=" + String.fromCharCode(icon) + ", len(rain)=" + raindata.length + ", ts=" + ts + ", sunrise=" + sunrise + ", " + ((new Date()).getTime() - jsStartTime) + "ms after start.");
 // -- end build
-        Pebble.sendAppMessage(data);
-    };
+    return load_rain ? {ts: ts, data: raindata} : null;
+}
 
-    var runRequest = function (url, parse) {
-        concurrentRequests([url], function(res) { parse(res[0]); });
-    };
+/** Fletcher-16 checksum of a precipitation series (the same as perc_checksum on the watch). */
+function percChecksum(data) {
+    var sum1 = 0;
+    var sum2 = 0;
+    for (var i = 0; i < data.length; i++) {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
 
-    var temp_unknown = 32767;
+/**
+ * Encode a precipitation series relative to the one the watch last acknowledged (shifted to the new start
+ * time), as a list of changed hours.  Returns null if that isn't possible, or not shorter than the full series.
+ */
+function rainDelta(ts, raindata) {
+    var acked = JSON.parse(localStorage.getItem("GRAPHITE_ACKED_RAIN") || "null");
+    if (acked === null || ts < acked.ts || (ts - acked.ts) % 3600 != 0) return null;
+    var shift = (ts - acked.ts) / 3600;
+    var patches = [];
+    for (var i = 0; i < raindata.length; i++) {
+        var old = i + shift < acked.data.length ? acked.data[i + shift] : 0;
+        if (old != raindata[i]) patches.push(i, raindata[i]);
+    }
+    var delta = encode_int_to_bytes(acked.ts, 4).concat(encode_int_to_bytes(percChecksum(acked.data), 2));
+    delta.push(patches.length / 2);
+    Array.prototype.push.apply(delta, patches);
+    return delta.length < raindata.length ? delta : null;
+}
+
+/** Weather results are fresh for this long (in ms, shorter than the minimal refresh interval of the watch). */
+var WEATHER_CACHE_TTL = 5 * 60 * 1000;
+/** Stale results are served (while revalidating) up to this age, in ms. */
+var WEATHER_CACHE_MAX_AGE = 3 * 60 * 60 * 1000;
+/** Weather requests currently in flight, by cache key. */
+var weatherInFlight = {};
+
+/** Base URL of a weather provider. */
+function weatherBaseUrl(source) {
+// -- build=debug
+// --     // point the weather requests at a local stub server, e.g. localStorage.setItem("GRAPHITE_WEATHER_STUB_URL", "http://192.168.1.5:8000")
+// --     var stub = localStorage.getItem("GRAPHITE_WEATHER_STUB_URL");
+// --     if (stub) return stub;
+    // point the weather requests at a local stub server, e.g. localStorage.setItem("GRAPHITE_WEATHER_STUB_URL", "http://192.168.1.5:8000")
+    var stub = localStorage.getItem("GRAPHITE_WEATHER_STUB_URL");
+    if (stub) return stub;
+// -- end build
+    if (source == 1) return "http://api.openweathermap.org";
+    if (source == 3) return "http://api.wunderground.com";
+    return "https://api.darksky.net";
+}
+
+/** Round a coordinate to about 1km, so that nearby locations share cached weather. */
+function roundCoordinate(x) {
+    return Math.round(x * 100) / 100;
+}
+
+/** Position fixes younger than this are used as is (in ms). */
+var LOCATION_MAX_AGE = 15 * 60 * 1000;
+/** Normally, a quick low accuracy fix is good enough; only if the last accurate fix is older, we ask for a new one (in ms). */
+var LOCATION_HIGH_ACCURACY_AGE = 6 * 60 * 60 * 1000;
+
+/**
+ * Determine the location for the weather, and call succ(latitude, longitude) or fail.  Uses the configured location
+ * if there is one, and otherwise the last position fix (if recent enough), a cheap low accuracy fix, or (rarely) a high
+ * accuracy one.  Coordinates are rounded, so that the weather cache hits for nearby locations.
+ */
+function getLocation(succ, fail) {
+    var location = readConfig("CONFIG_WEATHER_LOCATION_LOCAL");
+    if (location) {
+        var loc = location.split(",");
+        succ(roundCoordinate(+loc[0]), roundCoordinate(+loc[1]));
+        return;
+    }
 
+    var cached = JSON.parse(localStorage.getItem("GRAPHITE_LOCATION") || "null");
+    var now = Date.now();
+    if (cached !== null && now - cached.time < LOCATION_MAX_AGE) {
+        succ(cached.latitude, cached.longitude);
+        return;
+    }
+    // the first fix is a quick low accuracy one, too; high accuracy is only used to refresh an old fix
+    var highAccuracy = cached !== null && now - cached.accurate_time > LOCATION_HIGH_ACCURACY_AGE;
+    navigator.geolocation.getCurrentPosition(
+        function (pos) {
+            var fix = {
+                latitude: roundCoordinate(pos.coords.latitude),
+                longitude: roundCoordinate(pos.coords.longitude),
+                time: Date.now(),
+                accurate_time: highAccuracy || cached === null ? Date.now() : cached.accurate_time
+            };
+            localStorage.setItem("GRAPHITE_LOCATION", JSON.stringify(fix));
+            succ(fix.latitude, fix.longitude);
+        },
+        function (err) {
+            // the last known location is better than nothing
+            if (cached !== null) {
+                succ(cached.latitude, cached.longitude);
+            } else {
+                fail("location not found");
+            }
+        },
+        {enableHighAccuracy: highAccuracy, timeout: 15000, maximumAge: highAccuracy ? 60000 : LOCATION_MAX_AGE}
+    );
+}
+
+/** The cached weather for a given key, or null. */
+function readWeatherCache(key) {
+    var cache = localStorage.getItem("GRAPHITE_WEATHER_CACHE");
+    if (cache === null) return null;
+    cache = JSON.parse(cache);
+    if (cache.key !== key || Date.now() - cache.time > WEATHER_CACHE_MAX_AGE) return null;
+    return cache;
+}
+
+/**
+ * Get the weather for a location and send it to the watch.  Results are cached by provider, (rounded) location
+ * and the requested parts: fresh results are served from the cache, stale ones are served immediately and then
+ * revalidated.  Identical requests that are in flight are only made once.
+ */
+function fetchWeather(latitude, longitude) {
+    var nw = need_weather();
     var source = +readConfig("CONFIG_WEATHER_SOURCE_LOCAL");
-    var apikey = readConfig("CONFIG_WEATHER_APIKEY_LOCAL");
-    var low = temp_unknown;
-    var high = temp_unknown;
-    var cur = temp_unknown;
-    var icon = '';
-    var raindata = [];
-    var raints = 0;
-    var sunrise = 0;
-    var sunset = 0;
-    if (source == 1) {
-        var query = "lat=" + latitude + "&lon=" + longitude;
-        query += "&cnt=1&appid=fa5280deac4b98572739388b55cd7591";
-        query = "http://api.openweathermap.org/data/2.5/weather?" + query;
-        runRequest(query, function (response) {
-            cur = response.main.temp - 273.15;
-            low = temp_unknown;
-            high = temp_unknown;
-            icon = parseIconOpenWeatherMap(response.weather[0].icon);
-            sunrise = response.sys.sunrise;
-            sunset = response.sys.sunset;
-            success(low, high, cur, icon, raindata, raints, sunrise, sunset);
-        });
-    } else if (source == 3) {
-        var url0 = !load_cur ? undefined : "http://api.wunderground.com/api/" + apikey + "/conditions/q/" + latitude + "," + longitude + ".json";
-        var url1 = !load_lowhigh ? undefined : "http://api.wunderground.com/api/" + apikey + "/forecast/q/" + latitude + "," + longitude + ".json";
-        var url2 = !load_rain ? undefined : "http://api.wunderground.com/api/" + apikey + "/hourly/q/" + latitude + "," + longitude + ".json";
-        var url3 = !load_sun ? undefined : "http://api.wunderground.com/api/" + apikey + "/astronomy/q/" + latitude + "," + longitude + ".json";
-        concurrentRequests([url0,url1,url2,url3], function (responses) {
+    var key = [source, latitude, longitude, nw.slice(1).map(Number).join("")].join("|");
+
+    var cached = readWeatherCache(key);
+    var revalidate = false;
+    if (cached !== null) {
+        sendWeather(cached.result, nw, Math.max(0, Math.round((Date.now() - cached.time) / 1000)));
+        if (Date.now() < cached.expires) return;
+        revalidate = true;
+    }
+    if (weatherInFlight.hasOwnProperty(key)) {
+        // only stay quiet about failures if everyone waiting already got some weather
+        weatherInFlight[key].revalidate = weatherInFlight[key].revalidate && revalidate;
+        return;
+    }
+
+    var request = {revalidate: revalidate};
+    weatherInFlight[key] = request;
+    requestWeather(source, latitude, longitude, nw, function (result) {
+        delete weatherInFlight[key];
+        var time = Date.now();
+        localStorage.setItem("GRAPHITE_WEATHER_CACHE", JSON.stringify({key: key, time: time, expires: time + WEATHER_CACHE_TTL, result: result}));
+        // even if the conditions didn't change, the watch needs to learn that they are fresh now
+        sendWeather(result, nw);
+    }, function (err) {
+        delete weatherInFlight[key];
+        if (request.revalidate) {
 // -- build=debug
-// --             //console.log('[ info/app ] weather information: ' + JSON.stringify(response));
-            //console.log('[ info/app ] weather information: ' + JSON.stringify(response));
+// --             console.log('[ info/app ] weather revalidation failed: ' + err);
+            console.log('[ info/app ] weather revalidation failed: ' + err);
 // -- end build
-            if (load_lowhigh) {
-                for (var i in responses[1].forecast.simpleforecast.forecastday) {
-                    var data = responses[1].forecast.simpleforecast.forecastday[i];
-                    var date = new Date(data.date.epoch*1000);
-                    if (sameDate(now, date)) {
-                        high = +data.high.celsius;
-                        low = +data.low.celsius;
-                        break;
+            return;
+        }
+        failedWeatherCheck(err);
+    });
+}
+
+/**
+ * Quantize Dark Sky's minutely block into 4-bit levels (see nowcast_payload_* in scripts/initialize.py).  The
+ * expected intensity is scaled with a square root, so that light rain is still visible, and saturates at 10mm/h.
+ */
+function parseNowcastForecastIO(minutely) {
+    var data = [];
+    var ts = 0;
+    for (var i = 0; i < minutely.length; i++) {
+        var elem = minutely[i];
+        if (ts == 0) ts = elem.time;
+        if (!elem.hasOwnProperty('precipIntensity')) break;
+        var expected = elem.precipIntensity * (elem.hasOwnProperty('precipProbability') ? elem.precipProbability : 1);
+// -- autogen
+// --         if (data.length == {{ nowcast_minutes }}) break;
+        if (data.length == 60) break;
+// -- end autogen
+        data.push(Math.min(15, Math.round(15 * Math.sqrt(Math.min(expected, 10) / 10))));
+    }
+    return data.length == 0 ? null : {ts: ts, data: data};
+}
+
+/** A normalized weather result (temperatures in celsius, all parts unknown). */
+function emptyWeatherResult() {
+    var temp_unknown = 32767;
+    return {low: temp_unknown, high: temp_unknown, cur: temp_unknown, icon: '', raindata: [], ts: 0, sunrise: 0, sunset: 0, nowcast: null};
+}
+
+/**
+ * The weather providers, by CONFIG_WEATHER_SOURCE_LOCAL.  Each one can say which parts (as returned by
+ * need_weather) it supports, and can request the weather, calling done with a normalized result or fail.
+ * Requests return a handle that can be aborted.
+ */
+var WEATHER_PROVIDERS = {
+    1: {
+        name: "OpenWeatherMap",
+        supports: function(nw) { return !nw[1] && !nw[2]; },
+        request: function(apikey, latitude, longitude, nw, done, fail) {
+            var query = "lat=" + latitude + "&lon=" + longitude;
+            query += "&cnt=1&appid=fa5280deac4b98572739388b55cd7591";
+            query = weatherBaseUrl(1) + "/data/2.5/weather?" + query;
+            return concurrentRequests([query], function (responses) {
+                var response = responses[0];
+                var res = emptyWeatherResult();
+                res.cur = response.main.temp - 273.15;
+                res.icon = parseIconOpenWeatherMap(response.weather[0].icon);
+                res.sunrise = response.sys.sunrise;
+                res.sunset = response.sys.sunset;
+                done(res);
+            }, fail);
+        }
+    },
+    2: {
+        name: "DarkSky",
+        supports: function(nw) { return true; },
+        request: function(apikey, latitude, longitude, nw, done, fail) {
+            var now = new Date();
+            var load_rain = nw[1];
+            var load_lowhigh = nw[2];
+            var load_cur = nw[3];
+            var load_sun = nw[4];
+            var baseurl = weatherBaseUrl(2) + "/forecast/" + apikey + "/" + latitude + "," + longitude + "?units=si&";
+            var exclude = "exclude=alerts,flags";
+            if (!load_rain) exclude += ",minutely,hourly";
+            if (!load_lowhigh && !load_sun) exclude += ",daily";
+            if (!load_cur) exclude += ",currently";
+            return concurrentRequests([baseurl + exclude], function (responses) {
+                var response = responses[0];
+// -- build=debug
+// --                 //console.log('[ info/app ] weather information: ' + JSON.stringify(response));
+                //console.log('[ info/app ] weather information: ' + JSON.stringify(response));
+// -- end build
+                var res = emptyWeatherResult();
+                if (load_lowhigh || load_sun) {
+                    var found = false;
+                    for (var i in response.daily.data) {
+                        var data = response.daily.data[i];
+                        var date = new Date(data.time*1000);
+                        if (sameDate(now, date)) {
+                            if (load_lowhigh) {
+                                res.low = data.temperatureMin;
+                                res.high = data.temperatureMax;
+                            }
+                            if (load_sun) {
+                                res.sunrise = data.sunriseTime;
+                                res.sunset = data.sunsetTime;
+                            }
+                            found = true;
+                            break;
+                        }
+                    }
+                    if (!found) {
+                        fail("could not find current date");
+                        return;
                     }
                 }
-            }
-            if (load_cur) {
-                cur = responses[0].current_observation.temp_c;
-                icon = parseIconWU(responses[0].current_observation.icon);
-            }
-            if (load_rain) {
-                for (var i in responses[2].hourly_forecast) {
-                    var elem = responses[2].hourly_forecast[i];
-                    if (raints == 0) {
-                        // we don't get any data for the current hour from wunderground (why???)
-                        // so we just pretend the current hour is the same as the next hour
-                        raints = elem.FCTTIME.epoch - 3600;
-                        raindata.push(Math.round(elem.pop));
+                if (load_cur) {
+                    res.cur = response.currently.temperature;
+                    res.icon = parseIconForecastIO(response.currently.icon);
+                }
+                if (load_rain) {
+                    for (var i in response.hourly.data) {
+                        var elem = response.hourly.data[i];
+                        if (res.ts == 0) res.ts = elem.time;
+                        if (!elem.hasOwnProperty('precipProbability')) break;
+                        res.raindata.push(Math.round(elem.precipProbability * 100));
+                    }
+                    if (response.minutely && response.minutely.data) {
+                        res.nowcast = parseNowcastForecastIO(response.minutely.data);
                     }
-                    raindata.push(Math.round(elem.pop));
                 }
-            }
-            if (load_sun) {
-                var d = new Date();
-                var today = (d.getMonth()+1) + "/" + d.getDate() + "/" + d.getFullYear() + " ";
-                sunrise = Math.round(Date.parse(today + responses[3].sun_phase.sunrise.hour + ":" + responses[3].sun_phase.sunrise.minute) / 1000);
-                sunset = Math.round(Date.parse(today + responses[3].sun_phase.sunset.hour + ":" + responses[3].sun_phase.sunset.minute)/1000);
-            }
-            success(low, high, cur, icon, raindata, raints, sunrise, sunset);
-        });
-    } else {
-        // source == 2
-        var baseurl = "https://api.darksky.net/forecast/" + apikey + "/" + latitude + "," + longitude + "?units=si&";
-        var exclude = "exclude=minutely,alerts,flags";
-        if (!load_rain) exclude += ",hourly";
-        if (!load_lowhigh && !load_sun) exclude += ",daily";
-        if (!load_cur) exclude += ",currently";
-        runRequest(baseurl + exclude, function(response) {
-// -- build=debug
-// --             //console.log('[ info/app ] weather information: ' + JSON.stringify(response));
-            //console.log('[ info/app ] weather information: ' + JSON.stringify(response));
-// -- end build
-            if (load_lowhigh || load_sun) {
-                for (var i in response.daily.data) {
-                    var data = response.daily.data[i];
-                    var date = new Date(data.time*1000);
-                    if (sameDate(now, date)) {
-                        if (load_lowhigh) {
-                            low = data.temperatureMin;
-                            high = data.temperatureMax;
-                        }
-                        if (load_sun) {
-                            sunrise = data.sunriseTime;
-                            sunset = data.sunsetTime;
+                done(res);
+            }, fail);
+        }
+    },
+    3: {
+        name: "Weather Underground",
+        supports: function(nw) { return true; },
+        request: function(apikey, latitude, longitude, nw, done, fail) {
+            var now = new Date();
+            var load_rain = nw[1];
+            var load_lowhigh = nw[2];
+            var load_cur = nw[3];
+            var load_sun = nw[4];
+            var baseurl = weatherBaseUrl(3) + "/api/" + apikey;
+            var loc = "/q/" + latitude + "," + longitude + ".json";
+            var url0 = !load_cur ? undefined : baseurl + "/conditions" + loc;
+            var url1 = !load_lowhigh ? undefined : baseurl + "/forecast" + loc;
+            var url2 = !load_rain ? undefined : baseurl + "/hourly" + loc;
+            var url3 = !load_sun ? undefined : baseurl + "/astronomy" + loc;
+            return concurrentRequests([url0,url1,url2,url3], function (responses) {
+                var res = emptyWeatherResult();
+                if (load_lowhigh) {
+                    for (var i in responses[1].forecast.simpleforecast.forecastday) {
+                        var data = responses[1].forecast.simpleforecast.forecastday[i];
+                        var date = new Date(data.date.epoch*1000);
+                        if (sameDate(now, date)) {
+                            res.high = +data.high.celsius;
+                            res.low = +data.low.celsius;
+                            break;
                         }
-                        break;
                     }
                 }
-                if (low === temp_unknown) {
-                    failedWeatherCheck("could not find current date");
-                    return;
+                if (load_cur) {
+                    res.cur = responses[0].current_observation.temp_c;
+                    res.icon = parseIconWU(responses[0].current_observation.icon);
                 }
-            }
-            if (load_cur) {
-                cur = response.currently.temperature;
-                icon = parseIconForecastIO(response.currently.icon);
-            }
-            if (load_rain) {
-                for (var i in response.hourly.data) {
-                    var elem = response.hourly.data[i];
-                    if (raints == 0) raints = elem.time;
-                    if (!elem.hasOwnProperty('precipProbability')) break;
-                    raindata.push(Math.round(elem.precipProbability * 100));
+                if (load_rain) {
+                    for (var i in responses[2].hourly_forecast) {
+                        var elem = responses[2].hourly_forecast[i];
+                        if (res.ts == 0) {
+                            // we don't get any data for the current hour from wunderground (why???)
+                            // so we just pretend the current hour is the same as the next hour
+                            res.ts = elem.FCTTIME.epoch - 3600;
+                            res.raindata.push(Math.round(elem.pop));
+                        }
+                        res.raindata.push(Math.round(elem.pop));
+                    }
+                }
+                if (load_sun) {
+                    var today = (now.getMonth()+1) + "/" + now.getDate() + "/" + now.getFullYear() + " ";
+                    res.sunrise = Math.round(Date.parse(today + responses[3].sun_phase.sunrise.hour + ":" + responses[3].sun_phase.sunrise.minute) / 1000);
+                    res.sunset = Math.round(Date.parse(today + responses[3].sun_phase.sunset.hour + ":" + responses[3].sun_phase.sunset.minute)/1000);
                 }
+                done(res);
+            }, fail);
+        }
+    }
+};
+
+/** Number of recent response times remembered per weather provider. */
+var WEATHER_LATENCY_SAMPLES = 20;
+
+/** Remember how long a weather provider took to answer (in ms). */
+function recordWeatherLatency(source, ms) {
+    var latencies = JSON.parse(localStorage.getItem("GRAPHITE_WEATHER_LATENCY") || "{}");
+    var samples = latencies[source] || [];
+    samples.push(ms);
+    if (samples.length > WEATHER_LATENCY_SAMPLES) samples.shift();
+    latencies[source] = samples;
+    localStorage.setItem("GRAPHITE_WEATHER_LATENCY", JSON.stringify(latencies));
+}
+
+/**
+ * How long to wait for a weather provider before also asking the fallback: its recent 90th percentile
+ * response time (or a default while we know too little about it).
+ */
+function weatherHedgeDelay(source) {
+    var latencies = JSON.parse(localStorage.getItem("GRAPHITE_WEATHER_LATENCY") || "{}");
+    var samples = (latencies[source] || []).slice().sort(function(a, b) { return a - b; });
+    if (samples.length < 5) return 5000;
+    var p90 = samples[Math.min(samples.length - 1, Math.floor(samples.length * 0.9))];
+    return Math.max(1000, Math.min(p90, 20000));
+}
+
+/**
+ * Request the weather from the configured source, and call either done (with the result) or fail.  If a
+ * fallback source is configured (and supports everything we need), it is asked as well once the primary
+ * source takes longer than usual, or fails.  The first answer wins, and the other request is aborted.
+ */
+function requestWeather(source, latitude, longitude, nw, done, fail) {
+    var candidates = [{source: source, apikey: readConfig("CONFIG_WEATHER_APIKEY_LOCAL")}];
+    var fallback = +readConfig("CONFIG_WEATHER_FALLBACK_SOURCE_LOCAL");
+    if (fallback != source && WEATHER_PROVIDERS.hasOwnProperty(fallback) && WEATHER_PROVIDERS[fallback].supports(nw)) {
+        candidates.push({source: fallback, apikey: readConfig("CONFIG_WEATHER_FALLBACK_APIKEY_LOCAL")});
+    }
+
+    var finished = false;
+    var handles = [];
+    var failures = 0;
+    var hedgeTimer = null;
+    // how long each request took, recorded once (failed or aborted requests took at least that long)
+    var recorders = [];
+    var start = function (c) {
+        var t0 = Date.now();
+        var recorded = false;
+        var record = function () {
+            if (recorded) return;
+            recorded = true;
+            recordWeatherLatency(c.source, Date.now() - t0);
+        };
+        recorders.push(record);
+// -- build=debug
+// --         console.log('[ info/app ] requesting weather from ' + WEATHER_PROVIDERS[c.source].name);
+        console.log('[ info/app ] requesting weather from ' + WEATHER_PROVIDERS[c.source].name);
+// -- end build
+        handles.push(WEATHER_PROVIDERS[c.source].request(c.apikey, latitude, longitude, nw, function (result) {
+            record();
+            if (finished) return;
+            finished = true;
+            clearTimeout(hedgeTimer);
+            handles.forEach(function (h) { h.abort(); });
+            // the requests we gave up on were at least this slow
+            recorders.forEach(function (r) { r(); });
+            done(result);
+        }, function (err) {
+            record();
+            if (finished) return;
+            failures += 1;
+            if (handles.length < candidates.length) {
+                // don't wait for the hedge timer when the primary failed
+                clearTimeout(hedgeTimer);
+                start(candidates[handles.length]);
+            } else if (failures == handles.length) {
+                finished = true;
+                fail(err);
             }
-            success(low, high, cur, icon, raindata, raints, sunrise, sunset);
-        });
+        }));
+    };
+    start(candidates[0]);
+    if (candidates.length > 1) {
+        hedgeTimer = setTimeout(function () {
+            if (!finished && handles.length < candidates.length) start(candidates[handles.length]);
+        }, weatherHedgeDelay(source));
     }
 }
 
+/** The time zone table (see generate_tzdata in scripts/initialize.py), only loaded once a time zone is needed. */
+var tzdata = null;
+/** Time zones that have already been unpacked, by name. */
+var tzZones = {};
+
+/** Decode a base 60 number as packed by moment-timezone. */
+function unpackBase60(string) {
+    var digit = function (code) {
+        return code > 96 ? code - 87 : code > 64 ? code - 29 : code - 48;
+    };
+    var i = 0;
+    var sign = 1;
+    var parts = string.split('.');
+    var whole = parts[0];
+    var fractional = parts[1] || '';
+    var multiplier = 1;
+    var res = 0;
+    if (string.charCodeAt(0) === 45) {
+        i = 1;
+        sign = -1;
+    }
+    for (; i < whole.length; i++) {
+        res = 60 * res + digit(whole.charCodeAt(i));
+    }
+    for (i = 0; i < fractional.length; i++) {
+        multiplier = multiplier / 60;
+        res += digit(fractional.charCodeAt(i)) * multiplier;
+    }
+    return res * sign;
+}
 
-var moment = require('./moment-timezone');
+/**
+ * The offsets (in minutes west of UTC) and the times (in milliseconds) until which they are valid for a time zone,
+ * or null if the zone is unknown.
+ */
+function tzZone(name) {
+    if (tzZones.hasOwnProperty(name)) return tzZones[name];
+    if (tzdata === null) tzdata = require('./tzdata');
+    if (!tzdata.names.hasOwnProperty(name)) return null;
+    var packed = tzdata.zones[tzdata.names[name]].split('|');
+    var offsets = packed[0].split(' ').map(unpackBase60);
+    var indices = packed[1].split('').map(unpackBase60);
+    var deltas = packed[2].split(' ').map(unpackBase60);
+    var zone = {offsets: [], untils: []};
+    for (var i = 0; i < indices.length; i++) {
+        zone.offsets.push(offsets[indices[i]]);
+        // transitions are stored as differences in minutes, and the last offset is valid forever
+        zone.untils.push(i == indices.length - 1 ? Infinity : Math.round((zone.untils[i - 1] || 0) + 60000 * deltas[i]));
+    }
+    tzZones[name] = zone;
+    return zone;
+}
 
 function toTimestamp(t) {
     return Math.round(t / 1000)
@@ -771,8 +1594,21 @@ function encode_int_to_bytes(val, nbytes) {
 }
 
 function sendTzUpdate(idx) {
+    var data = packTz(idx);
+    if (data === null) return;
+    var pebbledata = {};
+    pebbledata["MSG_KEY_TZ_" + idx] = data;
+    Pebble.sendAppMessage(pebbledata);
+}
+
+/** The next few transitions of a configured time zone, as sent in MSG_KEY_TZ_*, or null if unknown. */
+function packTz(idx) {
     var now = (new Date()).getTime();
-    var zoneData = moment.tz.zone(readConfig("CONFIG_TZ_" + idx + "_LOCAL"));
+    var zoneData = tzZone(readConfig("CONFIG_TZ_" + idx + "_LOCAL"));
+    if (zoneData === null) {
+        console.log('[ info/app ] unknown time zone ' + readConfig("CONFIG_TZ_" + idx + "_LOCAL"));
+        return null;
+    }
     var untils = zoneData.untils;
     var found = false;
     var id = 0;
@@ -786,7 +1622,7 @@ function sendTzUpdate(idx) {
     found = found && id >= 0;
     if (!found) {
         console.log('[ info/app ] error finding tz info');
-        return;
+        return null;
     }
     var data = [];
     var i = 0;
@@ -813,14 +1649,15 @@ function sendTzUpdate(idx) {
         console.log('    offset = ' + offset);
 // -- end build
     }
-
-    var pebbledata = {};
-    var key = "MSG_KEY_TZ_" + idx;
-    pebbledata[key] = data;
-    Pebble.sendAppMessage(pebbledata);
+    return data;
 }
 
 
+/** The phone battery level and charging state last reported to the watch (or null). */
+var lastSentBattery = null;
+/** Are we listening to battery events? */
+var batterySubscribed = false;
+
 function sendBatteryLevel() {
     if (!navigator.getBattery) {
         var data = {
@@ -834,17 +1671,125 @@ function sendBatteryLevel() {
         return;
     }
 
+    navigator.getBattery().then(reportBattery);
+}
+
+function reportBattery(battery) {
+    var level = Math.round(battery.level * 100);
+    var data = {
+        "MSG_KEY_PHONEBAT": level
+    };
+// -- build=debug
+// --     console.log('[ info/app ] phone battery = ' + battery.level  + ".");
+    console.log('[ info/app ] phone battery = ' + battery.level  + ".");
+// -- end build
+    lastSentBattery = {level: level, charging: battery.charging};
+    Pebble.sendAppMessage(data, function () {}, function () {
+        // make sure the next change gets reported
+        lastSentBattery = null;
+    });
+}
+
+/**
+ * In push mode, the watch doesn't poll the phone battery.  Instead, we report it whenever the level leaves
+ * the hysteresis band around the last reported level, or the charging state changes.  The level is also re-sent
+ * twice per expiration period, so the watch can tell when this script stopped running.
+ */
+function subscribeBattery() {
+    if (batterySubscribed || !navigator.getBattery || +readConfig("CONFIG_PHONE_BATTERY_PUSH") == 0) return;
+    batterySubscribed = true;
     navigator.getBattery().then(function(battery) {
-        var level = Math.round(battery.level * 100);
-        var data = {
-            "MSG_KEY_PHONEBAT": level
+        var changed = function () {
+            // push mode might have been turned off in the meantime
+            if (+readConfig("CONFIG_PHONE_BATTERY_PUSH") == 0) return;
+            var level = Math.round(battery.level * 100);
+            var band = Math.max(1, +readConfig("CONFIG_PHONE_BATTERY_HYSTERESIS_LOCAL"));
+            if (lastSentBattery !== null && lastSentBattery.charging === battery.charging) {
+                var delta = Math.abs(level - lastSentBattery.level);
+                // always report reaching full or empty
+                var at_end = (level == 100 || level == 0) && delta > 0;
+                if (delta < band && !at_end) return;
+            }
+            reportBattery(battery);
+        };
+        var keepAlive = function () {
+            var expiration = Math.max(2, +readConfig("CONFIG_PHONE_BATTERY_EXPIRATION"));
+            setTimeout(function () {
+                if (+readConfig("CONFIG_PHONE_BATTERY_PUSH") != 0) reportBattery(battery);
+                keepAlive();
+            }, expiration / 2 * 60 * 1000);
         };
+        battery.addEventListener('levelchange', changed);
+        battery.addEventListener('chargingchange', changed);
+        changed();
+        keepAlive();
+    });
+}
+
+/**
+ * Tell the watch that we are ready, together with everything it is likely to ask for next: the cached weather (if
+ * it matches the configuration), the phone battery and the configured time zones.  MSG_KEY_WARM_START says how old
+ * the weather and phone battery are (see warm_start_* in scripts/initialize.py), so the watch can skip the fetches
+ * it doesn't need.
+ */
+function sendWarmStart() {
+    var data = {
+        "MSG_KEY_JS_READY": 1
+    };
+    var unknown_age = 0xffffffff;
+    var weather_age = unknown_age;
+    var phonebat_age = unknown_age;
+    var acked = undefined;
+
+    var nw = need_weather();
+    var cache = JSON.parse(localStorage.getItem("GRAPHITE_WEATHER_CACHE") || "null");
+    if (nw[0] && cache !== null && Date.now() - cache.time <= WEATHER_CACHE_MAX_AGE) {
+        // the location might have moved on since, but the source and requested parts need to match
+        var key = cache.key.split("|");
+        if (+key[0] == +readConfig("CONFIG_WEATHER_SOURCE_LOCAL") && key[3] == nw.slice(1).map(Number).join("")) {
+            acked = packWeather(cache.result, nw, data);
+            weather_age = Math.max(0, Math.round((Date.now() - cache.time) / 1000));
+        }
+    }
+// -- autogen
+// -- ## for i in range(num_tzs)
+// --     if (need_tz({{ i }})) data["MSG_KEY_TZ_{{ i }}"] = packTz({{ i }});
+// -- ## endfor
+    if (need_tz(0)) data["MSG_KEY_TZ_0"] = packTz(0);
+    if (need_tz(1)) data["MSG_KEY_TZ_1"] = packTz(1);
+    if (need_tz(2)) data["MSG_KEY_TZ_2"] = packTz(2);
+// -- end autogen
+    for (var k in data) {
+        if (data[k] === null) delete data[k];
+    }
+
+    var send = function () {
+        var tags = encode_int_to_bytes(weather_age, 4);
+        Array.prototype.push.apply(tags, encode_int_to_bytes(phonebat_age, 4));
+        data["MSG_KEY_WARM_START"] = tags;
 // -- build=debug
-// --             console.log('[ info/app ] phone battery = ' + battery.level  + ".");
-            console.log('[ info/app ] phone battery = ' + battery.level  + ".");
+// --         console.log('[ info/app ] warm start: ' + Object.keys(data).join(", ") + ", weather age=" + weather_age + ".");
+        console.log('[ info/app ] warm start: ' + Object.keys(data).join(", ") + ", weather age=" + weather_age + ".");
 // -- end build
-        Pebble.sendAppMessage(data);
-    });
+        Pebble.sendAppMessage(data, function () {
+            if (acked !== undefined) localStorage.setItem("GRAPHITE_ACKED_RAIN", JSON.stringify(acked));
+        }, function () {
+            if (acked !== undefined) localStorage.removeItem("GRAPHITE_ACKED_RAIN");
+            lastSentBattery = null;
+        });
+        subscribeBattery();
+    };
+    if (!need_phonebat() || !navigator.getBattery) {
+        send();
+        return;
+    }
+    navigator.getBattery().then(function (battery) {
+        var level = Math.round(battery.level * 100);
+        data["MSG_KEY_PHONEBAT"] = level;
+        phonebat_age = 0;
+        lastSentBattery = {level: level, charging: battery.charging};
+        send();
+    }, send);
 }
 
 Pebble.addEventListener('appmessage',
@@ -854,23 +1799,18 @@ Pebble.addEventListener('appmessage',
         console.log('[ info/app ] app message received: ' + JSON.stringify(e));
 // -- end build
         var dict = e.payload;
+        if (dict["MSG_KEY_CONFIG_HASH"] !== undefined) {
+            receivedConfigHash(dict["MSG_KEY_CONFIG_HASH"]);
+        }
+        if (dict["MSG_KEY_CONFIG_FAILED"]) {
+            receivedConfigFailed();
+        }
+        if (dict["MSG_KEY_WEATHER_RESYNC"]) {
+            // the watch couldn't apply our last precipitation delta
+            localStorage.removeItem("GRAPHITE_ACKED_RAIN");
+        }
         if (dict["MSG_KEY_FETCH_WEATHER"]) {
-            var location = readConfig("CONFIG_WEATHER_LOCATION_LOCAL");
-            if (location) {
-                var loc = location.split(",");
-                fetchWeather(loc[0], loc[1]);
-            } else {
-                navigator.geolocation.getCurrentPosition(
-                    function (pos) {
-                        var coordinates = pos.coords;
-                        fetchWeather(coordinates.latitude, coordinates.longitude);
-                    },
-                    function (err) {
-                        failedWeatherCheck("location not found");
-                    },
-                    {timeout: 15000, maximumAge: 60000}
-                );
-            }
+            getLocation(fetchWeather, failedWeatherCheck);
         }
         if (dict["MSG_KEY_FETCH_PHONEBAT"]) {
             sendBatteryLevel();
@@ -1 +0,0 @@
-../../config/js/moment.js
\ No newline at end of file
@@ -0,0 +1,8 @@
+// generated by scripts/initialize.py from config/js/moment-timezone.js, do not edit
+module.exports = {
+    version: "2017b",
+    // zone (or link) name -> index into zones
+    names: {"Africa/Abidjan":0,"Africa/Accra":0,"Africa/Addis_Ababa":1,"Africa/Algiers":2,"Africa/Asmara":1,"Africa/Asmera":1,"Africa/Bamako":0,"Africa/Bangui":3,"Africa/Banjul":0,"Africa/Bissau":0,"Africa/Blantyre":4,"Africa/Brazzaville":3,"Africa/Bujumbura":4,"Africa/Cairo":5,"Africa/Casablanca":6,"Africa/Ceuta":7,"Africa/Conakry":0,"Africa/Dakar":0,"Africa/Dar_es_Salaam":1,"Africa/Djibouti":1,"Africa/Douala":3,"Africa/El_Aaiun":6,"Africa/Freetown":0,"Africa/Gaborone":4,"Africa/Harare":4,"Africa/Johannesburg":8,"Africa/Juba":1,"Africa/Kampala":1,"Africa/Khartoum":1,"Africa/Kigali":4,"Africa/Kinshasa":3,"Africa/Lagos":3,"Africa/Libreville":3,"Africa/Lome":0,"Africa/Luanda":3,"Africa/Lubumbashi":4,"Africa/Lusaka":4,"Africa/Malabo":3,"Africa/Maputo":4,"Africa/Maseru":8,"Africa/Mbabane":8,"Africa/Mogadishu":1,"Africa/Monrovia":0,"Africa/Nairobi":1,"Africa/Ndjamena":3,"Africa/Niamey":3,"Africa/Nouakchott":0,"Africa/Ouagadougou":0,"Africa/Porto-Novo":3,"Africa/Sao_Tome":0,"Africa/Timbuktu":0,"Africa/Tripoli":9,"Africa/Tunis":2,"Africa/Windhoek":10,"America/Adak":11,"America/Anchorage":12,"America/Anguilla":13,"America/Antigua":13,"America/Araguaina":14,"America/Argentina/Buenos_Aires":15,"America/Argentina/Catamarca":15,"America/Argentina/ComodRivadavia":15,"America/Argentina/Cordoba":15,"America/Argentina/Jujuy":15,"America/Argentina/La_Rioja":15,"America/Argentina/Mendoza":15,"America/Argentina/Rio_Gallegos":15,"America/Argentina/Salta":15,"America/Argentina/San_Juan":15,"America/Argentina/San_Luis":15,"America/Argentina/Tucuman":15,"America/Argentina/Ushuaia":15,"America/Aruba":13,"America/Asuncion":16,"America/Atikokan":17,"America/Atka":11,"America/Bahia":18,"America/Bahia_Banderas":19,"America/Barbados":13,"America/Belem":15,"America/Belize":20,"America/Blanc-Sablon":13,"America/Boa_Vista":21,"America/Bogota":22,"America/Boise":23,"America/Buenos_Aires":15,"America/Cambridge_Bay":23,"America/Campo_Grande":24,"America/Cancun":25,"America/Caracas":26,"America/Catamarca":15,"America/Cayenne":15,"America/Cayman":17,"America/Chicago":27,"America/Chihuahua":28,"America/Coral_Harbour":17,"America/Cordoba":15,"America/Costa_Rica":20,"America/Creston":29,"America/Cuiaba":24,"America/Curacao":13,"America/Danmarkshavn":0,"America/Dawson":30,"America/Dawson_Creek":29,"America/Denver":23,"America/Detroit":31,"America/Dominica":13,"America/Edmonton":23,"America/Eirunepe":32,"America/El_Salvador":20,"America/Ensenada":30,"America/Fort_Nelson":33,"America/Fort_Wayne":31,"America/Fortaleza":15,"America/Glace_Bay":34,"America/Godthab":35,"America/Goose_Bay":34,"America/Grand_Turk":36,"America/Grenada":13,"America/Guadeloupe":13,"America/Guatemala":20,"America/Guayaquil":22,"America/Guyana":21,"America/Halifax":34,"America/Havana":37,"America/Hermosillo":29,"America/Indiana/Indianapolis":31,"America/Indiana/Knox":27,"America/Indiana/Marengo":31,"America/Indiana/Petersburg":31,"America/Indiana/Tell_City":27,"America/Indiana/Vevay":31,"America/Indiana/Vincennes":31,"America/Indiana/Winamac":31,"America/Indianapolis":31,"America/Inuvik":23,"America/Iqaluit":31,"America/Jamaica":17,"America/Jujuy":15,"America/Juneau":12,"America/Kentucky/Louisville":31,"America/Kentucky/Monticello":31,"America/Knox_IN":27,"America/Kralendijk":13,"America/La_Paz":21,"America/Lima":22,"America/Los_Angeles":30,"America/Louisville":31,"America/Lower_Princes":13,"America/Maceio":15,"America/Managua":20,"America/Manaus":21,"America/Marigot":13,"America/Martinique":13,"America/Matamoros":27,"America/Mazatlan":28,"America/Mendoza":15,"America/Menominee":27,"America/Merida":19,"America/Metlakatla":38,"America/Mexico_City":19,"America/Miquelon":39,"America/Moncton":34,"America/Monterrey":19,"America/Montevideo":40,"America/Montreal":31,"America/Montserrat":13,"America/Nassau":31,"America/New_York":31,"America/Nipigon":31,"America/Nome":12,"America/Noronha":41,"America/North_Dakota/Beulah":27,"America/North_Dakota/Center":27,"America/North_Dakota/New_Salem":27,"America/Ojinaga":23,"America/Panama":17,"America/Pangnirtung":31,"America/Paramaribo":15,"America/Phoenix":29,"America/Port-au-Prince":42,"America/Port_of_Spain":13,"America/Porto_Acre":32,"America/Porto_Velho":21,"America/Puerto_Rico":13,"America/Punta_Arenas":43,"America/Rainy_River":27,"America/Rankin_Inlet":27,"America/Recife":15,"America/Regina":20,"America/Resolute":27,"America/Rio_Branco":32,"America/Rosario":15,"America/Santa_Isabel":30,"America/Santarem":15,"America/Santiago":44,"America/Santo_Domingo":13,"America/Sao_Paulo":45,"America/Scoresbysund":46,"America/Shiprock":23,"America/Sitka":12,"America/St_Barthelemy":13,"America/St_Johns":47,"America/St_Kitts":13,"America/St_Lucia":13,"America/St_Thomas":13,"America/St_Vincent":13,"America/Swift_Current":20,"America/Tegucigalpa":20,"America/Thule":34,"America/Thunder_Bay":31,"America/Tijuana":30,"America/Toronto":31,"America/Tortola":13,"America/Vancouver":30,"America/Virgin":13,"America/Whitehorse":30,"America/Winnipeg":27,"America/Yakutat":12,"America/Yellowknife":23,"Antarctica/Casey":48,"Antarctica/Davis":49,"Antarctica/DumontDUrville":50,"Antarctica/Macquarie":51,"Antarctica/Mawson":52,"Antarctica/McMurdo":53,"Antarctica/Palmer":43,"Antarctica/Rothera":15,"Antarctica/South_Pole":53,"Antarctica/Syowa":54,"Antarctica/Troll":55,"Antarctica/Vostok":56,"Arctic/Longyearbyen":7,"Asia/Aden":54,"Asia/Almaty":56,"Asia/Amman":57,"Asia/Anadyr":58,"Asia/Aqtau":52,"Asia/Aqtobe":52,"Asia/Ashgabat":52,"Asia/Ashkhabad":52,"Asia/Atyrau":52,"Asia/Baghdad":54,"Asia/Bahrain":54,"Asia/Baku":59,"Asia/Bangkok":60,"Asia/Barnaul":61,"Asia/Beirut":62,"Asia/Bishkek":56,"Asia/Brunei":63,"Asia/Calcutta":64,"Asia/Chita":65,"Asia/Choibalsan":66,"Asia/Chongqing":67,"Asia/Chungking":67,"Asia/Colombo":68,"Asia/Dacca":56,"Asia/Damascus":69,"Asia/Dhaka":56,"Asia/Dili":70,"Asia/Dubai":71,"Asia/Dushanbe":52,"Asia/Famagusta":72,"Asia/Gaza":73,"Asia/Harbin":67,"Asia/Hebron":73,"Asia/Ho_Chi_Minh":60,"Asia/Hong_Kong":74,"Asia/Hovd":75,"Asia/Irkutsk":76,"Asia/Istanbul":77,"Asia/Jakarta":78,"Asia/Jayapura":79,"Asia/Jerusalem":80,"Asia/Kabul":81,"Asia/Kamchatka":58,"Asia/Karachi":82,"Asia/Kashgar":56,"Asia/Kathmandu":83,"Asia/Katmandu":83,"Asia/Khandyga":84,"Asia/Kolkata":64,"Asia/Krasnoyarsk":85,"Asia/Kuala_Lumpur":63,"Asia/Kuching":63,"Asia/Kuwait":54,"Asia/Macao":67,"Asia/Macau":67,"Asia/Magadan":86,"Asia/Makassar":87,"Asia/Manila":63,"Asia/Muscat":71,"Asia/Nicosia":88,"Asia/Novokuznetsk":60,"Asia/Novosibirsk":89,"Asia/Omsk":90,"Asia/Oral":52,"Asia/Phnom_Penh":60,"Asia/Pontianak":78,"Asia/Pyongyang":91,"Asia/Qatar":54,"Asia/Qyzylorda":56,"Asia/Rangoon":92,"Asia/Riyadh":54,"Asia/Saigon":60,"Asia/Sakhalin":93,"Asia/Samarkand":52,"Asia/Seoul":94,"Asia/Shanghai":67,"Asia/Singapore":63,"Asia/Srednekolymsk":95,"Asia/Taipei":67,"Asia/Tashkent":52,"Asia/Tbilisi":71,"Asia/Tehran":96,"Asia/Tel_Aviv":80,"Asia/Thimbu":56,"Asia/Thimphu":56,"Asia/Tokyo":97,"Asia/Tomsk":98,"Asia/Ujung_Pandang":87,"Asia/Ulaanbaatar":66,"Asia/Ulan_Bator":66,"Asia/Urumqi":56,"Asia/Ust-Nera":99,"Asia/Vientiane":60,"Asia/Vladivostok":99,"Asia/Yakutsk":84,"Asia/Yangon":92,"Asia/Yekaterinburg":100,"Asia/Yerevan":71,"Atlantic/Azores":46,"Atlantic/Bermuda":34,"Atlantic/Canary":101,"Atlantic/Cape_Verde":102,"Atlantic/Faeroe":101,"Atlantic/Faroe":101,"Atlantic/Jan_Mayen":7,"Atlantic/Madeira":101,"Atlantic/Reykjavik":0,"Atlantic/South_Georgia":41,"Atlantic/St_Helena":0,"Atlantic/Stanley":15,"Australia/ACT":103,"Australia/Adelaide":104,"Australia/Brisbane":105,"Australia/Broken_Hill":104,"Australia/Canberra":103,"Australia/Currie":103,"Australia/Darwin":106,"Australia/Eucla":107,"Australia/Hobart":103,"Australia/LHI":108,"Australia/Lindeman":105,"Australia/Lord_Howe":108,"Australia/Melbourne":103,"Australia/NSW":103,"Australia/North":106,"Australia/Perth":109,"Australia/Queensland":105,"Australia/South":104,"Australia/Sydney":103,"Australia/Tasmania":103,"Australia/Victoria":103,"Australia/West":109,"Australia/Yancowinna":104,"Brazil/Acre":32,"Brazil/DeNoronha":41,"Brazil/East":45,"Brazil/West":21,"CET":7,"CST6CDT":27,"Canada/Atlantic":34,"Canada/Central":27,"Canada/East-Saskatchewan":20,"Canada/Eastern":31,"Canada/Mountain":23,"Canada/Newfoundland":47,"Canada/Pacific":30,"Canada/Saskatchewan":20,"Canada/Yukon":30,"Chile/Continental":44,"Chile/EasterIsland":110,"Cuba":37,"EET":88,"EST":17,"EST5EDT":31,"Egypt":5,"Eire":111,"Etc/GMT":0,"Etc/GMT+0":0,"Etc/GMT+1":102,"Etc/GMT+10":112,"Etc/GMT+11":113,"Etc/GMT+12":114,"Etc/GMT+2":41,"Etc/GMT+3":15,"Etc/GMT+4":21,"Etc/GMT+5":22,"Etc/GMT+6":115,"Etc/GMT+7":116,"Etc/GMT+8":117,"Etc/GMT+9":118,"Etc/GMT-0":0,"Etc/GMT-1":119,"Etc/GMT-10":50,"Etc/GMT-11":51,"Etc/GMT-12":58,"Etc/GMT-13":120,"Etc/GMT-14":121,"Etc/GMT-2":122,"Etc/GMT-3":54,"Etc/GMT-4":71,"Etc/GMT-5":52,"Etc/GMT-6":56,"Etc/GMT-7":60,"Etc/GMT-8":63,"Etc/GMT-9":70,"Etc/GMT0":0,"Etc/Greenwich":0,"Etc/UCT":123,"Etc/UTC":124,"Etc/Universal":124,"Etc/Zulu":124,"Europe/Amsterdam":7,"Europe/Andorra":7,"Europe/Astrakhan":125,"Europe/Athens":88,"Europe/Belfast":126,"Europe/Belgrade":7,"Europe/Berlin":7,"Europe/Bratislava":7,"Europe/Brussels":7,"Europe/Bucharest":88,"Europe/Budapest":7,"Europe/Busingen":7,"Europe/Chisinau":127,"Europe/Copenhagen":7,"Europe/Dublin":111,"Europe/Gibraltar":7,"Europe/Guernsey":126,"Europe/Helsinki":88,"Europe/Isle_of_Man":126,"Europe/Istanbul":77,"Europe/Jersey":126,"Europe/Kaliningrad":128,"Europe/Kiev":88,"Europe/Kirov":129,"Europe/Lisbon":101,"Europe/Ljubljana":7,"Europe/London":126,"Europe/Luxembourg":7,"Europe/Madrid":7,"Europe/Malta":7,"Europe/Mariehamn":88,"Europe/Minsk":54,"Europe/Monaco":7,"Europe/Moscow":130,"Europe/Nicosia":88,"Europe/Oslo":7,"Europe/Paris":7,"Europe/Podgorica":7,"Europe/Prague":7,"Europe/Riga":88,"Europe/Rome":7,"Europe/Samara":71,"Europe/San_Marino":7,"Europe/Sarajevo":7,"Europe/Saratov":131,"Europe/Simferopol":132,"Europe/Skopje":7,"Europe/Sofia":88,"Europe/Stockholm":7,"Europe/Tallinn":88,"Europe/Tirane":7,"Europe/Tiraspol":127,"Europe/Ulyanovsk":125,"Europe/Uzhgorod":88,"Europe/Vaduz":7,"Europe/Vatican":7,"Europe/Vienna":7,"Europe/Vilnius":88,"Europe/Volgograd":129,"Europe/Warsaw":7,"Europe/Zagreb":7,"Europe/Zaporozhye":88,"Europe/Zurich":7,"GB":126,"GB-Eire":126,"GMT":0,"GMT+0":0,"GMT-0":0,"GMT0":0,"Greenwich":0,"HST":133,"Hongkong":74,"Iceland":0,"Indian/Antananarivo":1,"Indian/Chagos":56,"Indian/Christmas":60,"Indian/Cocos":92,"Indian/Comoro":1,"Indian/Kerguelen":52,"Indian/Mahe":71,"Indian/Maldives":52,"Indian/Mauritius":71,"Indian/Mayotte":1,"Indian/Reunion":71,"Iran":96,"Israel":80,"Jamaica":17,"Japan":97,"Kwajalein":58,"Libya":9,"MET":134,"MST":29,"MST7MDT":23,"Mexico/BajaNorte":30,"Mexico/BajaSur":28,"Mexico/General":19,"NZ":53,"NZ-CHAT":135,"Navajo":23,"PRC":67,"PST8PDT":30,"Pacific/Apia":136,"Pacific/Auckland":53,"Pacific/Bougainville":137,"Pacific/Chatham":135,"Pacific/Chuuk":50,"Pacific/Easter":110,"Pacific/Efate":51,"Pacific/Enderbury":120,"Pacific/Fakaofo":120,"Pacific/Fiji":138,"Pacific/Funafuti":58,"Pacific/Galapagos":115,"Pacific/Gambier":118,"Pacific/Guadalcanal":51,"Pacific/Guam":139,"Pacific/Honolulu":133,"Pacific/Johnston":133,"Pacific/Kiritimati":121,"Pacific/Kosrae":51,"Pacific/Kwajalein":58,"Pacific/Majuro":58,"Pacific/Marquesas":140,"Pacific/Midway":141,"Pacific/Nauru":58,"Pacific/Niue":113,"Pacific/Norfolk":142,"Pacific/Noumea":51,"Pacific/Pago_Pago":141,"Pacific/Palau":70,"Pacific/Pitcairn":117,"Pacific/Pohnpei":51,"Pacific/Ponape":51,"Pacific/Port_Moresby":50,"Pacific/Rarotonga":112,"Pacific/Saipan":139,"Pacific/Samoa":141,"Pacific/Tahiti":112,"Pacific/Tarawa":58,"Pacific/Tongatapu":143,"Pacific/Truk":50,"Pacific/Wake":58,"Pacific/Wallis":58,"Pacific/Yap":50,"Poland":7,"Portugal":101,"ROC":67,"ROK":94,"Singapore":63,"Turkey":77,"UCT":123,"US/Alaska":12,"US/Aleutian":11,"US/Arizona":29,"US/Central":27,"US/East-Indiana":31,"US/Eastern":31,"US/Hawaii":133,"US/Indiana-Starke":27,"US/Michigan":31,"US/Mountain":23,"US/Pacific":30,"US/Pacific-New":30,"US/Samoa":141,"UTC":124,"Universal":124,"W-SU":130,"WET":101,"Zulu":124},
+    // offsets|indices|untils, packed like moment-timezone
+    zones: ["0|0|","-30|0|","-10|0|","-10|0|","-20|0|","-20 -30|01010|1M2m0 gL0 e10 mn0","0 -10|0101010101010101010101010101010101010101010|1H3C0 wM0 co0 go0 1o00 s00 dA0 vc0 11A0 A00 e00 y00 11A0 uM0 e00 Dc0 11A0 s00 e00 IM0 WM0 mo0 gM0 LA0 WM0 jA0 e00 Rc0 11A0 e00 e00 U00 11A0 8o0 e00 11A0 11A0 5A0 e00 17c0 1fA0 1a00","-10 -20|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","-20|0|","-20 -10 -20|0120|1IlA0 TA0 1o00","-20 -10|01010101010101010101010|1GQo0 11B0 1qL0 WN0 1qL0 11B0 1nX0 11B0 1nX0 11B0 1nX0 11B0 1nX0 11B0 1qL0 WN0 1qL0 11B0 1nX0 11B0 1nX0 11B0","a0 90|01010101010101010101010|1GIc0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","90 80|01010101010101010101010|1GIb0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","40|0|","30 20|010|1IdD0 Lz0","30|0|","30 40|01010101010101010101010|1GTf0 1cN0 17b0 1ip0 17b0 1ip0 17b0 1ip0 19X0 1fB0 19X0 1fB0 19X0 1ip0 17b0 1ip0 17b0 1ip0 19X0 1fB0 19X0 1fB0","50|0|","20 30|01|1GCq0","60 50|01010101010101010101010|1GQw0 1nX0 14p0 1lb0 14p0 1lb0 14p0 1lb0 14p0 1nX0 11B0 1nX0 11B0 1nX0 14p0 1lb0 14p0 1lb0 14p0 1nX0 11B0 1nX0","60|0|","40|0|","50|0|","70 60|01010101010101010101010|1GI90 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","30 40|01010101010101010101010|1GCr0 1zd0 Lz0 1C10 Lz0 1C10 On0 1zd0 On0 1zd0 On0 1zd0 On0 1C10 Lz0 1C10 Lz0 1C10 On0 1zd0 On0 1zd0","60 50 50|01010102|1GQw0 1nX0 14p0 1lb0 14p0 1lb0 Dd0","4u 40|01|1QMT0","60 50|01010101010101010101010|1GI80 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","70 60|01010101010101010101010|1GQx0 1nX0 14p0 1lb0 14p0 1lb0 14p0 1lb0 14p0 1nX0 11B0 1nX0 11B0 1nX0 14p0 1lb0 14p0 1lb0 14p0 1nX0 11B0 1nX0","70|0|","80 70|01010101010101010101010|1GIa0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","50 40|01010101010101010101010|1GI70 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","40 50|01|1KLE0","80 70 70|01010102|1GIa0 1zb0 Op0 1zb0 Op0 1zb0 Op0","40 30|01010101010101010101010|1GI60 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","30 20|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","50 40 40|010101012|1GI70 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0","50 40|01010101010101010101010|1GQt0 1qM0 Oo0 1zc0 Oo0 1zc0 Oo0 1zc0 Rc0 1zc0 Oo0 1zc0 Oo0 1zc0 Oo0 1zc0 Oo0 1zc0 Rc0 1zc0 Oo0 1zc0","80 90 80|0121212121212121|1PAa0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","30 20|01010101010101010101010|1GI50 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","20 30|01010101|1GI40 1o10 11z0 1o10 11z0 1o10 11z0","20|0|","50 40|010101010101010101010|1GI70 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 3iN0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","30 40|010101010|1H3D0 Op0 1zb0 Rd0 1wn0 Rd0 46n0 Ap0","30 40|010101010101010101010|1H3D0 Op0 1zb0 Rd0 1wn0 Rd0 46n0 Ap0 1Nb0 Ap0 1Nb0 Ap0 1Nb0 Ap0 1Nb0 Ap0 1Nb0 Dd0 1Nb0 Ap0","20 30|01010101010101010101010|1GCq0 1zd0 Lz0 1C10 Lz0 1C10 On0 1zd0 On0 1zd0 On0 1zd0 On0 1C10 Lz0 1C10 Lz0 1C10 On0 1zd0 On0 1zd0","10 0|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","3u 2u|01010101010101010101010|1GI5u 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Op0 1zb0 Rd0 1zb0 Op0 1zb0","-b0 -80|010|1GAF0 blz0","-50 -70|01|1GAI0","-a0|0|","-b0|0|","-50|0|","-d0 -c0|01010101010101010101010|1GQe0 1cM0 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1cM0 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00","-30|0|","0 -20|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","-60|0|","-20 -30|010101010101010101010|1GPy0 4bX0 Dd0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 11A0 1o00","-c0|0|","-40 -50|010101010|1GNA0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00","-70|0|","-70 -60|010|1N7v0 3rd0","-20 -30|01010101010101010101010|1GNy0 1qL0 11B0 1nX0 11B0 1nX0 11B0 1nX0 11B0 1qL0 WN0 1qL0 WN0 1qL0 11B0 1nX0 11B0 1nX0 11B0 1qL0 WN0 1qL0","-80|0|","-5u|0|","-a0 -80 -90|012|1N7s0 3re0","-80 -90|01010|1O8G0 1cJ0 1cP0 1cJ0","-80|0|","-5u|0|","-20 -30|01010101010101010101010|1GPy0 1nX0 11B0 1nX0 11B0 1qL0 WN0 1qL0 WN0 1qL0 11B0 1nX0 11B0 1nX0 11B0 1nX0 11B0 1qL0 WN0 1qL0 WN0 1qL0","-90|0|","-40|0|","-20 -30 -30|01010101012|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 15U0","-20 -30|01010101010101010101010|1GPy0 1a00 1fA0 1cL0 1cN0 1nX0 1210 1nz0 1220 1qL0 WN0 1qL0 11B0 1nX0 11B0 1nX0 11B0 1qL0 WN0 1qL0 WN0 1qL0","-80|0|","-70 -80|01010|1O8H0 1cJ0 1cP0 1cJ0","-90 -80|01|1N7t0","-20 -30 -30|01010101012|1GNB0 1qM0 11A0 1o00 1200 1nA0 11A0 1tA0 U00 15w0","-70|0|","-90|0|","-20 -30|01010101010101010101010|1GPA0 1aL0 1eN0 1oL0 10N0 1oL0 10N0 1oL0 10N0 1rz0 W10 1rz0 W10 1rz0 10N0 1oL0 10N0 1oL0 10N0 1rz0 W10 1rz0","-4u|0|","-50|0|","-5J|0|","-a0 -90|01|1N7s0","-80 -70|01|1N7u0","-c0 -a0 -b0|012|1N7q0 3Cq0","-80|0|","-20 -30|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","-70 -60|010|1N7v0 4eN0","-70 -60|01|1N7v0","-90 -8u|01|1P4D0","-6u|0|","-b0 -a0|010|1N7r0 3rd0","-90|0|","-c0 -b0|01|1N7q0","-3u -4u|01010101010101010101010|1GLUu 1dz0 1cN0 1dz0 1cp0 1dz0 1cp0 1dz0 1cp0 1dz0 1cN0 1dz0 1cp0 1dz0 1cp0 1dz0 1cp0 1dz0 1cN0 1dz0 1cp0 1dz0","-90|0|","-70 -60|010|1N7v0 3Qp0","-b0 -a0|01|1N7r0","-60 -50|01|1N7w0","0 -10|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","10|0|","-b0 -a0|01010101010101010101010|1GQg0 1fA0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1fA0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0","-au -9u|01010101010101010101010|1GQgu 1fA0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1fA0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0 1cM0","-a0|0|","-9u|0|","-8J|0|","-b0 -au|01010101010101010101010|1GQf0 1fAu 1cLu 1cMu 1cLu 1cMu 1cLu 1cMu 1cLu 1cMu 1cLu 1cMu 1cLu 1fAu 1cLu 1cMu 1cLu 1cMu 1cLu 1cMu 1cLu 1cMu","-80|0|","50 60|010101010101010101010|1H3D0 Op0 1zb0 Rd0 1wn0 Rd0 46n0 Ap0 1Nb0 Ap0 1Nb0 Ap0 1Nb0 Ap0 1Nb0 Ap0 1Nb0 Dd0 1Nb0 Ap0","0 -10|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","a0|0|","b0|0|","c0|0|","60|0|","70|0|","80|0|","90|0|","-10|0|","-d0|0|","-e0|0|","-20|0|","0|0|","0|0|","-40 -30|010|1N7y0 3rd0","0 -10|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","-20 -30|01010101010101010101010|1GNA0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","-30 -20|01|1N7z0","-40 -30|01|1N7y0","-40 -30|01|1N7y0","-40 -30|010|1N7y0 5810","-20 -30 -40 -30|0101023|1GNB0 1qM0 11A0 1o00 11z0 1nW0","a0|0|","-10 -20|01010101010101010101010|1GNB0 1qM0 11A0 1o00 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0 WM0 1qM0 11A0 1o00 11A0 1o00 11A0 1qM0 WM0 1qM0","-dJ -cJ|01010101010101010101010|1GQe0 1cM0 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1cM0 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00","-e0 -d0|01010101010101010101010|1GQe0 1cM0 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1cM0 1fA0 1a00 1fA0 1a00 1fA0 1a00 1fA0 1a00","-a0 -b0|01|1NwE0","-d0 -c0|01010101010101010101010|1Goe0 1Nc0 Ao0 1Q00 xz0 1SN0 uM0 1SM0 uM0 1VA0 s00 1VA0 uM0 1SM0 uM0 1SM0 uM0 1SM0 uM0 1VA0 s00 1VA0","-a0|0|","9u|0|","b0|0|","-bu -b0|01|1PoCu","-d0 -e0|01010101010101|1S4d0 s00 1VA0 uM0 1SM0 uM0 1SM0 uM0 1SM0 uM0 1VA0 s00 1VA0"]
+};
@@ -0,0 +1,650 @@
+// Copyright 2016 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "prerender.h"
+#include "graphite.h"
+
+/**
+ * Pebble apps cannot draw into an offscreen bitmap, so content is pre-rendered by drawing it into the frame buffer
+ * as part of a regular frame, copying it out, and then painting over it.  Later frames copy it back in, instead of
+ * drawing it again.
+ *
+ * This is used for the secondary widgets: they are pre-rendered whenever something they might show has changed,
+ * so that a tap only needs to copy two bands of pixels.  They are pre-rendered in a separate redraw shortly after
+ * the frame that noticed the change, so the minute tick doesn't draw twelve widgets.  Optionally
+ * (CONFIG_PRERENDER_NEXT_MINUTE), the whole frame of the next minute is pre-rendered a few seconds before the minute
+ * starts, and the minute tick only needs to copy it onto the screen.  The secondary widgets of the next minute are
+ * pre-rendered along with it, and kept until the minute starts.
+ *
+ * While a timeline peek slides in or out, the first frame of the animation is drawn and kept, and every later frame
+ * copies it, and moves the band with the time and date (the only thing that depends on the obstructed height) to
+ * where it would be drawn.  The frame at the end of the animation is drawn normally.
+ *
+ * In ambient mode (see update_ambient_mode), the top bar with the rain preview and the widgets are drawn once,
+ * and then frozen: every later frame copies them, and only draws the time, date and progress bar.  They are drawn
+ * again every hour (the rain preview moves along with the time), when the weather or phone battery expire, when
+ * quiet time starts or ends, or every minute if a widget shows the time.
+ */
+typedef struct {
+    GRect top;
+    GRect bottom;
+    time_t minute;
+    uint32_t generation;
+    uint8_t top_color;
+    bool quiet;
+    bool weather;
+    bool sunrise;
+    bool phonebat;
+} SecondaryKey;
+
+typedef struct {
+    GBitmap* top;
+    GBitmap* bottom;
+    SecondaryKey key;
+    bool valid;
+} SecondaryCache;
+
+/** The secondary widgets of the current minute, and of the next minute (while it is pre-rendered). */
+static SecondaryCache secondary;
+static SecondaryCache next_secondary;
+/** Is the secondary widgets redraw due, and is it the frame being drawn? */
+static bool secondary_requested = false;
+static bool secondary_frame = false;
+
+typedef struct {
+    GRect bounds;
+    time_t minute;
+    uint32_t generation;
+    bool quiet;
+    bool secondary;
+    bool bluetooth_popup;
+} FrameKey;
+
+static GBitmap* next_frame = NULL;
+static FrameKey next_frame_key;
+static bool next_frame_valid = false;
+static bool next_frame_requested = false;
+
+static GBitmap* peek_frame = NULL;
+static FrameKey peek_frame_key;
+static bool peek_frame_valid = false;
+static bool peek_animating = false;
+/** Where the time and date are in peek_frame, how far they may move, and the offset they were drawn with. */
+static GRect peek_band;
+static GRect peek_clip;
+static fixed_t peek_offset;
+static bool peek_band_valid = false;
+
+typedef struct {
+    GRect bounds;
+    time_t hour;
+    time_t minute;
+    uint32_t generation;
+    bool weather;
+    bool sunrise;
+    bool phonebat;
+    bool quiet;
+} FrozenKey;
+
+/** Widgets that show the time (and are outdated every minute), by widget id. */
+static const bool widget_clock[] = {
+// -- autogen
+// -- ## for key in widgets_idsorted
+// --     {{ "true" if key["clock"] else "false" }}, // {{ key["key"] | lower }}
+// -- ## endfor
+    false, // widget_empty
+    false, // widget_weather_cur_temp_icon
+    false, // widget_weather_cur_temp
+    false, // widget_weather_cur_icon
+    false, // widget_weather_low_temp
+    false, // widget_weather_high_temp
+    false, // widget_bluetooth_disconly
+    false, // widget_bluetooth_disconly_alt
+    false, // widget_bluetooth_yesno
+    false, // widget_battery_icon
+    false, // widget_quiet_offonly
+    false, // widget_quiet
+    false, // widget_steps_icon
+    false, // widget_steps
+    false, // widget_steps_short_icon
+    false, // widget_steps_short
+    false, // widget_calories_resting_icon
+    false, // widget_calories_resting
+    false, // widget_calories_active_icon
+    false, // widget_calories_active
+    false, // widget_calories_all_icon
+    false, // widget_calories_all
+    false, // widget_calories_resting_short_icon
+    false, // widget_calories_resting_short
+    false, // widget_calories_active_short_icon
+    false, // widget_calories_active_short
+    false, // widget_calories_all_short_icon
+    false, // widget_calories_all_short
+    true, // widget_ampm
+    true, // widget_ampm_lower
+    true, // widget_seconds
+    true, // widget_day_of_week
+    false, // widget_battery_text
+    false, // widget_battery_text2
+    true, // widget_tz_0
+    true, // widget_tz_1
+    true, // widget_tz_2
+    false, // widget_weather_sunrise_icon0
+    false, // widget_weather_sunrise_icon1
+    false, // widget_weather_sunrise_icon2
+    false, // widget_weather_sunset_icon0
+    false, // widget_weather_sunset_icon1
+    false, // widget_weather_sunset_icon2
+    false, // widget_phone_battery_icon
+    false, // widget_phone_battery_text
+    false, // widget_phone_battery_text2
+    false, // widget_both_battery_icon
+    false, // widget_both_battery_flipped_icon
+    false, // widget_both_battery_text
+    false, // widget_both_battery_flipped_text
+    false, // widget_both_battery_text2
+    false, // widget_both_battery_flipped_text2
+// -- end autogen
+};
+
+/** Widgets that show health data (and might change every minute), by widget id. */
+static const bool widget_health[] = {
+// -- autogen
+// -- ## for key in widgets_idsorted
+// --     {{ "true" if key["health"] else "false" }}, // {{ key["key"] | lower }}
+// -- ## endfor
+    false, // widget_empty
+    false, // widget_weather_cur_temp_icon
+    false, // widget_weather_cur_temp
+    false, // widget_weather_cur_icon
+    false, // widget_weather_low_temp
+    false, // widget_weather_high_temp
+    false, // widget_bluetooth_disconly
+    false, // widget_bluetooth_disconly_alt
+    false, // widget_bluetooth_yesno
+    false, // widget_battery_icon
+    false, // widget_quiet_offonly
+    false, // widget_quiet
+    true, // widget_steps_icon
+    true, // widget_steps
+    true, // widget_steps_short_icon
+    true, // widget_steps_short
+    true, // widget_calories_resting_icon
+    true, // widget_calories_resting
+    true, // widget_calories_active_icon
+    true, // widget_calories_active
+    true, // widget_calories_all_icon
+    true, // widget_calories_all
+    true, // widget_calories_resting_short_icon
+    true, // widget_calories_resting_short
+    true, // widget_calories_active_short_icon
+    true, // widget_calories_active_short
+    true, // widget_calories_all_short_icon
+    true, // widget_calories_all_short
+    false, // widget_ampm
+    false, // widget_ampm_lower
+    false, // widget_seconds
+    false, // widget_day_of_week
+    false, // widget_battery_text
+    false, // widget_battery_text2
+    false, // widget_tz_0
+    false, // widget_tz_1
+    false, // widget_tz_2
+    false, // widget_weather_sunrise_icon0
+    false, // widget_weather_sunrise_icon1
+    false, // widget_weather_sunrise_icon2
+    false, // widget_weather_sunset_icon0
+    false, // widget_weather_sunset_icon1
+    false, // widget_weather_sunset_icon2
+    false, // widget_phone_battery_icon
+    false, // widget_phone_battery_text
+    false, // widget_phone_battery_text2
+    false, // widget_both_battery_icon
+    false, // widget_both_battery_flipped_icon
+    false, // widget_both_battery_text
+    false, // widget_both_battery_flipped_text
+    false, // widget_both_battery_text2
+    false, // widget_both_battery_flipped_text2
+// -- end autogen
+};
+
+static GBitmap* frozen_top = NULL;
+static GBitmap* frozen_bottom = NULL;
+static GRect frozen_top_rect;
+static GRect frozen_bottom_rect;
+static FrozenKey frozen_key;
+static bool frozen_valid = false;
+
+/** Bumped whenever data shown by widgets changes. */
+static uint32_t prerender_generation = 0;
+
+/** How far ahead of the current time the frame being drawn is. */
+static time_t frame_time_offset = 0;
+
+/**
+ * The time that is being drawn.  This is the current time, except while the next minute is pre-rendered.
+ */
+time_t frame_time() {
+    return time(NULL) + frame_time_offset;
+}
+
+/**
+ * Does one of the given widgets show the time (or, if health is set, health data)?
+ */
+static bool widgets_by_minute(const uint8_t* ids, unsigned count, bool health) {
+    for (unsigned i = 0; i < count; i++) {
+        if (ids[i] < ARRAY_LENGTH(widget_clock) && widget_clock[ids[i]]) return true;
+        if (health && ids[i] < ARRAY_LENGTH(widget_health) && widget_health[ids[i]]) return true;
+    }
+    return false;
+}
+
+static SecondaryKey make_secondary_key(GRect top, GRect bottom, uint8_t top_color) {
+    uint8_t ids[] = {config_widget_7, config_widget_8, config_widget_9, config_widget_10, config_widget_11, config_widget_12};
+    SecondaryKey key;
+    // the key is compared with memcmp, so clear the padding
+    memset(&key, 0, sizeof(key));
+    key.top = top;
+    key.bottom = bottom;
+    // other widgets only change along with prerender_generation, or when their data expires
+    if (widgets_by_minute(ids, ARRAY_LENGTH(ids), true)) key.minute = frame_time() / 60;
+    key.generation = prerender_generation;
+    key.top_color = top_color;
+    key.quiet = quiet_time_is_active();
+    // outdated data is hidden, without a change to the data
+    key.weather = show_weather();
+    key.sunrise = show_weather_impl(config_weather_sunrise_expiration * 60);
+    key.phonebat = showPhoneBattery();
+    return key;
+}
+
+/**
+ * The secondary widgets for the frame that is being drawn.
+ */
+static SecondaryCache* frame_secondary() {
+    return frame_time_offset == 0 ? &secondary : &next_secondary;
+}
+
+static void free_secondary(SecondaryCache* cache) {
+    cache->valid = false;
+    if (cache->top) gbitmap_destroy(cache->top);
+    if (cache->bottom) gbitmap_destroy(cache->bottom);
+    cache->top = NULL;
+    cache->bottom = NULL;
+}
+
+static bool ensure_bitmap(GBitmap** bitmap, GSize size) {
+    if (*bitmap) {
+        GRect bounds = gbitmap_get_bounds(*bitmap);
+        if (bounds.size.w == size.w && bounds.size.h == size.h) return true;
+        gbitmap_destroy(*bitmap);
+    }
+    *bitmap = gbitmap_create_blank(size, PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit));
+    return *bitmap != NULL;
+}
+
+/**
+ * Copy a full-width band of the frame buffer into a bitmap of the same width.
+ */
+static void copy_rows(GBitmap* frame_buffer, GBitmap* bitmap, GRect rect) {
+    uint8_t* data = gbitmap_get_data(bitmap);
+    uint16_t stride = gbitmap_get_bytes_per_row(bitmap);
+    for (int y = 0; y < rect.size.h; y++) {
+        GBitmapDataRowInfo row = gbitmap_get_data_row_info(frame_buffer, rect.origin.y + y);
+#if defined(PBL_COLOR)
+        // on round displays, only part of every row exists
+        memcpy(data + y * stride + row.min_x, row.data + row.min_x, row.max_x - row.min_x + 1);
+#else
+        memcpy(data + y * stride, row.data, stride);
+#endif
+    }
+}
+
+static FrameKey make_frame_key(Layer *layer) {
+    FrameKey key;
+    // the key is compared with memcmp, so clear the padding
+    memset(&key, 0, sizeof(key));
+    key.bounds = layer_get_unobstructed_bounds(layer);
+    key.minute = frame_time() / 60;
+    key.generation = prerender_generation;
+    key.quiet = quiet_time_is_active();
+    key.secondary = show_secondary_widgets;
+    key.bluetooth_popup = show_bluetooth_popup;
+    return key;
+}
+
+static bool next_frame_enabled() {
+    return config_prerender_next_minute && config_update_second == 0 && startup_stage == STARTUP_DONE && !power_saver &&
+           !ambient_mode;
+}
+
+static void next_frame_timer(void *unused) {
+    next_frame_requested = true;
+    layer_mark_dirty(layer_background);
+}
+
+/**
+ * Schedule pre-rendering the next minute, unless it is too late for that already.
+ */
+static void schedule_next_frame() {
+    time_t s;
+    uint16_t ms;
+    time_ms(&s, &ms);
+    uint32_t until_next_minute = (60 - s % 60) * 1000 - ms;
+    if (until_next_minute <= GRAPHITE_PRERENDER_LEAD_MS) return;
+    schedule_task(TASK_PRERENDER, until_next_minute - GRAPHITE_PRERENDER_LEAD_MS, 0, next_frame_timer);
+}
+
+/**
+ * Draw the next minute, and copy it out of the frame buffer (it is painted over by the current minute afterwards).
+ */
+static void prerender_next_frame(Layer *layer, GContext *ctx) {
+    next_frame_valid = false;
+    GRect bounds = layer_get_bounds(layer);
+    if (!ensure_bitmap(&next_frame, bounds.size)) return;
+    time_t now = time(NULL);
+    frame_time_offset = 60 - now % 60;
+    background_update_proc(layer, ctx);
+    next_frame_key = make_frame_key(layer);
+    frame_time_offset = 0;
+    GBitmap* frame_buffer = graphics_capture_frame_buffer(ctx);
+    if (!frame_buffer) return;
+    copy_rows(frame_buffer, next_frame, bounds);
+    graphics_release_frame_buffer(ctx, frame_buffer);
+    next_frame_valid = true;
+}
+
+/**
+ * Called while drawing a frame, with the band that contains the time and date, the area it may be moved within,
+ * and the offset of the time (see time_offset).
+ */
+void prerender_peek_band(GRect band, GRect clip, fixed_t offset) {
+    peek_band = band;
+    peek_clip = clip;
+    peek_offset = offset;
+    peek_band_valid = band.size.h > 0;
+}
+
+/**
+ * Draw a frame of the timeline peek animation.  Returns false if the frame needs to be drawn normally.
+ */
+static bool prerender_peek_frame(Layer *layer, GContext *ctx) {
+    // the popup covers the top of the screen, and isn't worth the trouble
+    if (show_bluetooth_popup) return false;
+    FrameKey key = make_frame_key(layer);
+    GRect unobstructed = key.bounds;
+    key.bounds = GRectZero;
+    GRect bounds = layer_get_bounds(layer);
+
+    if (!peek_frame_valid || memcmp(&key, &peek_frame_key, sizeof(key)) != 0) {
+        peek_frame_valid = false;
+        if (!ensure_bitmap(&peek_frame, bounds.size)) return false;
+        peek_band_valid = false;
+        background_update_proc(layer, ctx);
+        if (!peek_band_valid) return true;
+        GBitmap* frame_buffer = graphics_capture_frame_buffer(ctx);
+        if (!frame_buffer) return true;
+        copy_rows(frame_buffer, peek_frame, bounds);
+        graphics_release_frame_buffer(ctx, frame_buffer);
+        peek_frame_key = key;
+        peek_frame_valid = true;
+        return true;
+    }
+
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+    graphics_draw_bitmap_in_rect(ctx, peek_frame, bounds);
+    fixed_t offset = time_offset(INT_TO_FIXED(bounds.size.h), INT_TO_FIXED(unobstructed.size.h));
+    int16_t delta = FIXED_TO_INT(FIXED_ROUND(offset - peek_offset));
+    if (delta == 0) return true;
+
+    // the band moves up by delta, and is clipped to the area between the rain preview and the bottom widgets
+    GRect dest = GRect(peek_band.origin.x, peek_band.origin.y - delta, peek_band.size.w, peek_band.size.h);
+    int16_t skip_top = peek_clip.origin.y - dest.origin.y;
+    int16_t skip_bottom = (dest.origin.y + dest.size.h) - (peek_clip.origin.y + peek_clip.size.h);
+    if (skip_top < 0) skip_top = 0;
+    if (skip_bottom < 0) skip_bottom = 0;
+    graphics_context_set_fill_color(ctx, COLOR(config_color_background));
+    graphics_fill_rect(ctx, peek_band, 0, GCornerNone);
+    if (skip_top + skip_bottom >= peek_band.size.h) return true;
+    GRect source = GRect(peek_band.origin.x, peek_band.origin.y + skip_top, peek_band.size.w,
+                         peek_band.size.h - skip_top - skip_bottom);
+    GBitmap* band = gbitmap_create_as_sub_bitmap(peek_frame, source);
+    if (!band) return true;
+    graphics_draw_bitmap_in_rect(ctx, band, GRect(source.origin.x, source.origin.y - delta, source.size.w, source.size.h));
+    gbitmap_destroy(band);
+    return true;
+}
+
+/**
+ * The obstruction of the screen is about to change (a timeline peek starts to slide in or out).
+ */
+void prerender_peek_begin() {
+    peek_animating = true;
+    peek_frame_valid = false;
+}
+
+/**
+ * The obstruction of the screen has changed: the end state is drawn normally, and the cached frame is freed.
+ */
+void prerender_peek_end() {
+    peek_animating = false;
+    peek_frame_valid = false;
+    if (peek_frame) gbitmap_destroy(peek_frame);
+    peek_frame = NULL;
+}
+
+/**
+ * The update procedure of the watch face: draws the frame with background_update_proc, unless the frame was
+ * pre-rendered and nothing it shows has changed since.
+ */
+void frame_update_proc(Layer *layer, GContext *ctx) {
+    secondary_frame = secondary_requested;
+    secondary_requested = false;
+    if (peek_animating && startup_stage == STARTUP_DONE && prerender_peek_frame(layer, ctx)) return;
+    if (!next_frame_enabled()) {
+        next_frame_valid = false;
+        next_frame_requested = false;
+        if (next_frame) gbitmap_destroy(next_frame);
+        next_frame = NULL;
+        free_secondary(&next_secondary);
+        background_update_proc(layer, ctx);
+        return;
+    }
+    if (next_frame_valid) {
+        FrameKey key = make_frame_key(layer);
+        if (memcmp(&key, &next_frame_key, sizeof(key)) == 0) {
+            next_frame_valid = false;
+            graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+            graphics_draw_bitmap_in_rect(ctx, next_frame, layer_get_bounds(layer));
+            // the secondary widgets drawn along with this frame are the current ones now
+            SecondaryCache previous = secondary;
+            secondary = next_secondary;
+            next_secondary = previous;
+            next_secondary.valid = false;
+            schedule_next_frame();
+            return;
+        }
+        if (key.minute >= next_frame_key.minute) next_frame_valid = false;
+    }
+    if (next_frame_requested) {
+        next_frame_requested = false;
+        prerender_next_frame(layer, ctx);
+    }
+    background_update_proc(layer, ctx);
+    schedule_next_frame();
+}
+
+/**
+ * The secondary widgets are only pre-rendered when they can be shown, and when they aren't outdated every second
+ * (and not in the power saver, where drawing them on demand is cheaper, or in ambient mode, where they can't be).
+ */
+bool prerender_secondary_enabled() {
+    return config_2nd_widgets && config_update_second == 0 && !power_saver && !ambient_mode;
+}
+
+/**
+ * Are the pre-rendered secondary widgets up-to-date for the given layout?
+ */
+bool prerender_secondary_valid(GRect top, GRect bottom, uint8_t top_color) {
+    SecondaryCache* cache = frame_secondary();
+    SecondaryKey key = make_secondary_key(top, bottom, top_color);
+    return cache->valid && memcmp(&key, &cache->key, sizeof(key)) == 0;
+}
+
+static void secondary_timer(void *unused) {
+    secondary_requested = true;
+    layer_mark_dirty(layer_background);
+}
+
+/**
+ * Should the outdated secondary widgets be drawn (and captured) in this frame?  That is the case while they are
+ * shown, while the next minute is pre-rendered, and in the redraw that is scheduled otherwise.
+ */
+bool prerender_secondary_due() {
+    if (show_secondary_widgets || frame_time_offset != 0 || secondary_frame) return true;
+    schedule_task(TASK_SECONDARY, GRAPHITE_PRERENDER_SECONDARY_DELAY_MS, 0, secondary_timer);
+    return false;
+}
+
+/**
+ * Copy the secondary widgets, which have just been drawn into the rectangles top and bottom, out of the frame buffer.
+ */
+void prerender_secondary_capture(GContext* ctx, GRect top, GRect bottom, uint8_t top_color) {
+    SecondaryCache* cache = frame_secondary();
+    cache->valid = false;
+    if (!ensure_bitmap(&cache->top, top.size) || !ensure_bitmap(&cache->bottom, bottom.size)) {
+        free_secondary(cache);
+        return;
+    }
+    GBitmap* frame_buffer = graphics_capture_frame_buffer(ctx);
+    if (!frame_buffer) return;
+    copy_rows(frame_buffer, cache->top, top);
+    copy_rows(frame_buffer, cache->bottom, bottom);
+    graphics_release_frame_buffer(ctx, frame_buffer);
+    cache->key = make_secondary_key(top, bottom, top_color);
+    cache->valid = true;
+}
+
+/**
+ * Draw the pre-rendered secondary widgets (only valid if prerender_secondary_valid).
+ */
+void prerender_secondary_draw(GContext* ctx) {
+    SecondaryCache* cache = frame_secondary();
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+    graphics_draw_bitmap_in_rect(ctx, cache->top, cache->key.top);
+    graphics_draw_bitmap_in_rect(ctx, cache->bottom, cache->key.bottom);
+}
+
+static FrozenKey make_frozen_key() {
+    uint8_t ids[] = {config_widget_1, config_widget_2, config_widget_3, config_widget_4, config_widget_5, config_widget_6};
+    FrozenKey key;
+    // the key is compared with memcmp, so clear the padding
+    memset(&key, 0, sizeof(key));
+    key.bounds = layer_get_unobstructed_bounds(layer_background);
+    key.hour = frame_time() / (60 * 60);
+    if (widgets_by_minute(ids, ARRAY_LENGTH(ids), false)) key.minute = frame_time() / 60;
+    key.generation = prerender_generation;
+    // outdated data is hidden, without a change to the data
+    key.weather = show_weather();
+    key.sunrise = show_weather_impl(config_weather_sunrise_expiration * 60);
+    key.phonebat = showPhoneBattery();
+    key.quiet = quiet_time_is_active();
+    return key;
+}
+
+/**
+ * Are the frozen top bar and widgets (see prerender_frozen_capture) still up-to-date?  The layout, the
+ * configuration and data changes outdate them, and so does the time (see make_frozen_key).
+ */
+bool prerender_frozen_valid() {
+    FrozenKey key = make_frozen_key();
+    return frozen_valid && memcmp(&key, &frozen_key, sizeof(key)) == 0;
+}
+
+/**
+ * Copy the top bar (including the rain preview) and the bottom widgets, which have just been drawn into the
+ * rectangles top and bottom, out of the frame buffer.
+ */
+void prerender_frozen_capture(GContext* ctx, GRect top, GRect bottom) {
+    frozen_valid = false;
+    if (!ensure_bitmap(&frozen_top, top.size) || !ensure_bitmap(&frozen_bottom, bottom.size)) {
+        prerender_frozen_free();
+        return;
+    }
+    GBitmap* frame_buffer = graphics_capture_frame_buffer(ctx);
+    if (!frame_buffer) return;
+    copy_rows(frame_buffer, frozen_top, top);
+    copy_rows(frame_buffer, frozen_bottom, bottom);
+    graphics_release_frame_buffer(ctx, frame_buffer);
+    frozen_top_rect = top;
+    frozen_bottom_rect = bottom;
+    frozen_key = make_frozen_key();
+    frozen_valid = true;
+}
+
+/**
+ * Draw the frozen top bar (only valid if prerender_frozen_valid).
+ */
+void prerender_frozen_draw_top(GContext* ctx) {
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+    graphics_draw_bitmap_in_rect(ctx, frozen_top, frozen_top_rect);
+}
+
+/**
+ * Draw the frozen bottom widgets (only valid if prerender_frozen_valid).
+ */
+void prerender_frozen_draw_bottom(GContext* ctx) {
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+    graphics_draw_bitmap_in_rect(ctx, frozen_bottom, frozen_bottom_rect);
+}
+
+/**
+ * Free the frozen top bar and widgets.
+ */
+void prerender_frozen_free() {
+    frozen_valid = false;
+    if (frozen_top) gbitmap_destroy(frozen_top);
+    if (frozen_bottom) gbitmap_destroy(frozen_bottom);
+    frozen_top = NULL;
+    frozen_bottom = NULL;
+}
+
+/**
+ * Mark everything pre-rendered as outdated.  Needs to be called whenever data shown by widgets changes (the
+ * time is taken care of automatically).
+ */
+void prerender_invalidate() {
+    prerender_generation += 1;
+}
+
+/**
+ * Free the pre-rendered secondary widgets.
+ */
+void prerender_secondary_free() {
+    free_secondary(&secondary);
+    free_secondary(&next_secondary);
+}
+
+/**
+ * Free all pre-rendered content.
+ */
+void prerender_deinit() {
+    prerender_peek_end();
+    prerender_frozen_free();
+    next_frame_valid = false;
+    if (next_frame) gbitmap_destroy(next_frame);
+    next_frame = NULL;
+    prerender_secondary_free();
+}
@@ -0,0 +1,40 @@
+// Copyright 2016 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef GRAPHITE_PRERENDER_H
+#define GRAPHITE_PRERENDER_H
+
+#include "graphite.h"
+
+time_t frame_time();
+void frame_update_proc(Layer *layer, GContext *ctx);
+void prerender_peek_band(GRect band, GRect clip, fixed_t offset);
+void prerender_peek_begin();
+void prerender_peek_end();
+bool prerender_secondary_enabled();
+bool prerender_secondary_valid(GRect top, GRect bottom, uint8_t top_color);
+bool prerender_secondary_due();
+void prerender_secondary_capture(GContext* ctx, GRect top, GRect bottom, uint8_t top_color);
+void prerender_secondary_draw(GContext* ctx);
+void prerender_secondary_free();
+bool prerender_frozen_valid();
+void prerender_frozen_capture(GContext* ctx, GRect top, GRect bottom);
+void prerender_frozen_draw_top(GContext* ctx);
+void prerender_frozen_draw_bottom(GContext* ctx);
+void prerender_frozen_free();
+void prerender_invalidate();
+void prerender_deinit();
+
+#endif //GRAPHITE_PRERENDER_H
@@ -0,0 +1,122 @@
+// Copyright 2016 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "scheduler.h"
+#include "graphite.h"
+
+/**
+ * A single timer wheel for all deferred work.  Every task has a window [earliest, latest] in which it may run.
+ * Only one AppTimer exists, and it fires at the earliest 'latest' of all pending tasks; whenever it fires (or the
+ * minute tick happens), all tasks whose window has opened run together.  Tasks with slack of at least a minute
+ * therefore usually ride along with the minute tick and never wake the watch on their own.
+ */
+typedef struct {
+    uint64_t earliest;
+    uint64_t latest;
+    AppTimerCallback callback;
+    bool pending;
+} ScheduledTask;
+
+static ScheduledTask tasks[GRAPHITE_NUM_TASKS];
+static AppTimer *scheduler_timer = NULL;
+
+static uint64_t now_ms() {
+    time_t s;
+    uint16_t ms;
+    time_ms(&s, &ms);
+    return (uint64_t)s * 1000 + ms;
+}
+
+static void scheduler_run(void *unused);
+
+/**
+ * (Re-)arm the single timer for the most urgent pending task.
+ */
+static void scheduler_arm() {
+    uint64_t next = UINT64_MAX;
+    for (int i = 0; i < GRAPHITE_NUM_TASKS; i++) {
+        if (tasks[i].pending && tasks[i].latest < next) next = tasks[i].latest;
+    }
+    if (next == UINT64_MAX) {
+        if (scheduler_timer) {
+            app_timer_cancel(scheduler_timer);
+            scheduler_timer = NULL;
+        }
+        return;
+    }
+    uint64_t now = now_ms();
+    uint32_t delay_ms = next <= now ? 0 : (uint32_t)MIN(next - now, GRAPHITE_SCHEDULER_MAX_DELAY_MS);
+    if (!scheduler_timer || !app_timer_reschedule(scheduler_timer, delay_ms)) {
+        scheduler_timer = app_timer_register(delay_ms, scheduler_run, NULL);
+    }
+}
+
+/**
+ * Run all tasks whose window has opened, returns whether there were any.
+ */
+static bool scheduler_run_due() {
+    uint64_t now = now_ms();
+    // collect first, as callbacks may schedule tasks again
+    bool due[GRAPHITE_NUM_TASKS];
+    bool any = false;
+    for (int i = 0; i < GRAPHITE_NUM_TASKS; i++) {
+        due[i] = tasks[i].pending && tasks[i].earliest <= now;
+        if (due[i]) {
+            tasks[i].pending = false;
+            any = true;
+        }
+    }
+    for (int i = 0; i < GRAPHITE_NUM_TASKS; i++) {
+        if (due[i]) tasks[i].callback(NULL);
+    }
+    return any;
+}
+
+static void scheduler_run(void *unused) {
+    scheduler_timer = NULL;
+    scheduler_run_due();
+    scheduler_arm();
+}
+
+/**
+ * Schedule a task (replacing any pending instance of it) to run after delay_ms, but no later than slack_ms after that.
+ */
+void schedule_task(Task task, uint32_t delay_ms, uint32_t slack_ms, AppTimerCallback callback) {
+    uint64_t now = now_ms();
+    tasks[task].earliest = now + delay_ms;
+    tasks[task].latest = now + delay_ms + slack_ms;
+    tasks[task].callback = callback;
+    tasks[task].pending = true;
+    scheduler_arm();
+}
+
+void cancel_task(Task task) {
+    if (!tasks[task].pending) return;
+    tasks[task].pending = false;
+    scheduler_arm();
+}
+
+/**
+ * Called on every minute tick; runs everything that is due anyway, to save a separate wakeup.
+ */
+void scheduler_minute_tick() {
+    if (scheduler_run_due()) scheduler_arm();
+}
+
+void scheduler_deinit() {
+    for (int i = 0; i < GRAPHITE_NUM_TASKS; i++) {
+        tasks[i].pending = false;
+    }
+    scheduler_arm();
+}
@@ -0,0 +1,39 @@
+// Copyright 2016 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRAPHITE_SCHEDULER_H
+#define GRAPHITE_SCHEDULER_H
+
+#include "graphite.h"
+
+/** All deferred work of the watchface.  Each task is pending at most once. */
+typedef enum {
+    TASK_WEATHER,
+    TASK_PHONEBAT,
+    TASK_TZ,
+    TASK_BLUETOOTH_POPUP,
+    TASK_TAP,
+    TASK_STARTUP,
+    TASK_PRERENDER,
+    TASK_SECONDARY,
+    TASK_OUTBOX,
+    GRAPHITE_NUM_TASKS
+} Task;
+
+void schedule_task(Task task, uint32_t delay_ms, uint32_t slack_ms, AppTimerCallback callback);
+void cancel_task(Task task);
+void scheduler_minute_tick();
+void scheduler_deinit();
+
+#endif //GRAPHITE_SCHEDULER_H
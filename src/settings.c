@@ -20,29 +20,161 @@
 static void update_weather_helper(void *unused);
 static void update_phonebat_helper(void *unused);
 
-void ask_for_update(uint8_t key) {
+/** Hash of the currently applied configuration. */
+static uint32_t config_hash;
+/** Should the next message to the phone report the configuration hash? */
+static bool config_hash_pending = false;
+/** Should the next message to the phone ask for a full weather record (because a delta didn't apply)? */
+static bool weather_resync_pending = false;
+/** Should the next message to the phone report that a configuration transfer was lost? */
+static bool config_failed_pending = false;
+
+/**
+ * Is something waiting to be piggybacked onto the next message to the phone?
+ */
+static bool piggyback_pending() {
+    return config_hash_pending || weather_resync_pending || config_failed_pending;
+}
+
+/**
+ * Send a message to the phone.  If requested, the configuration hash (or a lost configuration transfer, and a
+ * request for a full weather record) is piggybacked onto the message.  If the outbox is busy, nothing is sent, and
+ * the piggybacked values stay pending (see outbox_sent_handler).
+ */
+static void send_message(uint8_t key) {
     DictionaryIterator *iter;
-    app_message_outbox_begin(&iter);
-    dict_write_uint8(iter, key, 1);
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) return;
+    if (key != 0) {
+        dict_write_uint8(iter, key, 1);
+    }
+    if (config_hash_pending) {
+        dict_write_uint32(iter, MSG_KEY_CONFIG_HASH, config_hash);
+        config_hash_pending = false;
+    }
+    if (weather_resync_pending) {
+        dict_write_uint8(iter, MSG_KEY_WEATHER_RESYNC, 1);
+        weather_resync_pending = false;
+    }
+    if (config_failed_pending) {
+        dict_write_uint8(iter, MSG_KEY_CONFIG_FAILED, 1);
+        config_failed_pending = false;
+    }
     app_message_outbox_send();
 }
 
-void set_timer_impl(AppTimer** timer, int timeout_min, AppTimerCallback callback) {
-    const uint32_t timeout_ms = timeout_min * 1000 * 60;
-    if (*timer) {
-        if (!app_timer_reschedule(*timer, timeout_ms)) {
-            *timer = app_timer_register(timeout_ms, callback, NULL);
-        }
-    } else {
-        *timer = app_timer_register(timeout_ms, callback, NULL);
+void ask_for_update(uint8_t key) {
+    send_message(key);
+}
+
+static void outbox_retry(void *unused) {
+    if (piggyback_pending()) send_message(0);
+}
+
+/**
+ * The outbox is free again: send whatever is still pending.
+ */
+void outbox_sent_handler(DictionaryIterator *iter, void *context) {
+    outbox_retry(NULL);
+}
+
+/**
+ * A message didn't make it to the phone: whatever was piggybacked onto it is pending again, and is retried after a
+ * while (or with the next message, while disconnected).
+ */
+void outbox_failed_handler(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+    if (dict_find(iter, MSG_KEY_CONFIG_HASH)) config_hash_pending = true;
+    if (dict_find(iter, MSG_KEY_WEATHER_RESYNC)) weather_resync_pending = true;
+    if (dict_find(iter, MSG_KEY_CONFIG_FAILED)) config_failed_pending = true;
+    if (piggyback_pending() && bluetooth_connection_service_peek()) {
+        schedule_task(TASK_OUTBOX, GRAPHITE_OUTBOX_RETRY_MS, 0, outbox_retry);
     }
 }
 
+/**
+ * Schedule a background fetch; these have some slack, so they can be combined with other wakeups.
+ */
+void set_timer_impl(Task task, int timeout_min, AppTimerCallback callback) {
+    // clamp before converting, so the delay can't overflow
+    uint32_t delay_min = MIN((uint32_t)MAX(timeout_min, 0), GRAPHITE_SCHEDULER_MAX_DELAY_MS / (60 * 1000));
+    uint32_t delay_ms = delay_min * 60 * 1000;
+    schedule_task(task, delay_ms, GRAPHITE_SCHEDULER_FETCH_SLACK_MS, callback);
+}
+
 void set_weather_timer(int timeout_min) {
-    set_timer_impl(&weather_request_timer, timeout_min, update_weather_helper);
+    set_timer_impl(TASK_WEATHER, timeout_min, update_weather_helper);
 }
 
-bool update_helper(bool force, time_t ts, AppTimer** timer, int timeout_min, AppTimerCallback callback, uint8_t key) {
+/** Number of weather requests that failed in a row. */
+static uint8_t weather_failures = 0;
+/** Number of refreshes in a row that didn't change the weather or phone battery level, respectively. */
+static uint8_t weather_unchanged = 0;
+static uint8_t phonebat_unchanged = 0;
+
+/**
+ * Is precipitation likely within the next hour (according to the rain forecast we have)?
+ */
+static bool rain_imminent() {
+    if (weather.timestamp == 0 || weather.failed) return false;
+    const int sec_in_hour = 60*60;
+    time_t now = time(NULL);
+    for (int i = 0; i < weather.perc_data_len; i++) {
+        time_t hour_ts = weather.perc_data_ts + i * sec_in_hour;
+        if (hour_ts + sec_in_hour <= now) continue;
+        if (hour_ts > now + sec_in_hour) break;
+        if (weather.perc_data[i] >= GRAPHITE_REFRESH_RAIN_PROB) return true;
+    }
+    return false;
+}
+
+/**
+ * Compute the refresh interval based on the configured one.  It is stretched while the user is asleep, during
+ * quiet time, while bluetooth is disconnected and when the last refreshes didn't change anything; it is tightened
+ * when rain is imminent.
+ */
+static int adaptive_interval(int timeout_min, uint8_t unchanged, bool rain) {
+    int factor = 1;
+    if (rain) {
+        timeout_min = MIN(timeout_min, GRAPHITE_REFRESH_RAIN_INTERVAL);
+    } else {
+        factor <<= MIN(unchanged, GRAPHITE_REFRESH_MAX_UNCHANGED);
+    }
+    if (user_sleeping() || quiet_time_is_active()) factor *= 2;
+    if (!bluetooth_connection_service_peek()) factor *= 2;
+    return timeout_min * MIN(factor, GRAPHITE_REFRESH_MAX_STRETCH);
+}
+
+/**
+ * Retry interval after a failed weather request: exponential backoff starting at the configured retry interval,
+ * capped at the regular interval, with some jitter so that retries don't line up with other wakeups.
+ */
+static int backoff_interval() {
+    int timeout_min = config_weather_refresh_failed << MIN(weather_failures - 1, GRAPHITE_REFRESH_MAX_BACKOFF);
+    timeout_min = MIN(timeout_min, MAX(config_weather_refresh, config_weather_refresh_failed));
+    int jitter = timeout_min * GRAPHITE_REFRESH_JITTER_PERCENT / 100;
+    if (jitter > 0) {
+        timeout_min += rand() % (2 * jitter + 1) - jitter;
+    }
+    return MAX(timeout_min, 1);
+}
+
+/**
+ * Did the weather not change (compared to the previous weather), apart from the forecast moving along in time?
+ */
+static bool same_weather(const Weather *prev, const Weather *cur) {
+    if (prev->timestamp == 0 || prev->failed) return false;
+    if (prev->icon != cur->icon || prev->temp_cur != cur->temp_cur || prev->temp_low != cur->temp_low
+        || prev->temp_high != cur->temp_high) return false;
+    // compare the hours both rain forecasts cover
+    int shift = (cur->perc_data_ts - prev->perc_data_ts) / (60*60);
+    for (int i = 0; i < cur->perc_data_len; i++) {
+        int j = i + shift;
+        if (j < 0 || j >= prev->perc_data_len) continue;
+        if (prev->perc_data[j] != cur->perc_data[i]) return false;
+    }
+    return true;
+}
+
+bool update_helper(bool force, time_t ts, Task task, int timeout_min, AppTimerCallback callback, uint8_t key) {
     bool need = false;
     if (ts == 0) {
         need = true;
@@ -53,7 +185,7 @@ bool update_helper(bool force, time_t ts, AppTimer** timer, int timeout_min, App
             if (timeout_min == 0) timeout_min = 1;
         }
     }
-    set_timer_impl(timer, timeout_min, callback);
+    set_timer_impl(task, timeout_min, callback);
     if (!need && !force) return false;
 
     // actually update the weather by sending a request
@@ -66,25 +198,35 @@ bool update_helper(bool force, time_t ts, AppTimer** timer, int timeout_min, App
  * Update the weather information (and schedule a periodic timer to update again)
  */
 void update_weather(bool force) {
-    // return if we don't want weather information
+    // return if we don't want weather information (or don't fetch anything right now)
     if (config_weather_refresh == 0) return;
+    if (fetches_suspended()) {
+        cancel_task(TASK_WEATHER);
+        return;
+    }
 
-    bool done = update_helper(force, weather.timestamp, &weather_request_timer, config_weather_refresh, update_weather_helper, MSG_KEY_FETCH_WEATHER);
+    int timeout_min = adaptive_interval(config_weather_refresh, weather_unchanged, rain_imminent());
+    bool done = update_helper(force, weather.timestamp, TASK_WEATHER, timeout_min, update_weather_helper, MSG_KEY_FETCH_WEATHER);
 
 // -- build=debug
-// --     if (done) APP_LOG(APP_LOG_LEVEL_INFO, "requesting weather update");
-    if (done) APP_LOG(APP_LOG_LEVEL_INFO, "requesting weather update");
+// --     if (done) APP_LOG(APP_LOG_LEVEL_INFO, "requesting weather update (interval %d min)", timeout_min);
+    if (done) APP_LOG(APP_LOG_LEVEL_INFO, "requesting weather update (interval %d min)", timeout_min);
 // -- end build
 }
 
 void update_phonebat(bool force) {
-    if (config_phone_battery_refresh == 0) return;
+    // in push mode, the phone reports changes on its own (and nothing is fetched while fetches are suspended)
+    if (config_phone_battery_refresh == 0 || config_phone_battery_push || fetches_suspended()) {
+        cancel_task(TASK_PHONEBAT);
+        return;
+    }
 
-    bool done = update_helper(force, phonebat.timestamp, &phone_battery_request_timer, config_phone_battery_refresh, update_phonebat_helper, MSG_KEY_FETCH_PHONEBAT);
+    int timeout_min = adaptive_interval(config_phone_battery_refresh, phonebat_unchanged, false);
+    bool done = update_helper(force, phonebat.timestamp, TASK_PHONEBAT, timeout_min, update_phonebat_helper, MSG_KEY_FETCH_PHONEBAT);
 
 // -- build=debug
-// --     if (done) APP_LOG(APP_LOG_LEVEL_INFO, "requesting phone battery update");
-    if (done) APP_LOG(APP_LOG_LEVEL_INFO, "requesting phone battery update");
+// --     if (done) APP_LOG(APP_LOG_LEVEL_INFO, "requesting phone battery update (interval %d min)", timeout_min);
+    if (done) APP_LOG(APP_LOG_LEVEL_INFO, "requesting phone battery update (interval %d min)", timeout_min);
 // -- end build
 }
 
@@ -92,12 +234,10 @@ void update_phonebat(bool force) {
  * Utility function.
  */
 static void update_weather_helper(void *unused) {
-    weather_request_timer = NULL;
     update_weather(false);
 }
 
 static void update_phonebat_helper(void *unused) {
-    phone_battery_request_timer = NULL;
     update_phonebat(false);
 }
 
@@ -117,7 +257,7 @@ int8_t get_current_tz_idx(TZData* data) {
 /**
  * Check if we need to update the timezone.
  */
-void check_update_tz_helper(uint8_t idx, uint32_t key) {
+void check_update_tz_helper(uint8_t idx, uint8_t key) {
     // return if we don't use the timezone widget
     // TODO
 
@@ -140,16 +280,38 @@ void check_update_tz_helper(uint8_t idx, uint32_t key) {
     }
 
     // actually request a tz update
-    DictionaryIterator *iter;
-    app_message_outbox_begin(&iter);
-    dict_write_uint8(iter, key, 1);
-    app_message_outbox_send();
+    ask_for_update(key);
 
 // -- build=debug
 // --     APP_LOG(APP_LOG_LEVEL_INFO, "requesting tz update for %d", idx);
     APP_LOG(APP_LOG_LEVEL_INFO, "requesting tz update for %d", idx);
 // -- end build
 }
+static void check_update_tz_timer(void *unused) {
+    check_update_tz();
+}
+
+/**
+ * Schedule the next timezone check for when the first of the current timezone data is about to expire.
+ */
+static void schedule_tz_check() {
+    time_t now = time(NULL);
+    time_t next = 0;
+    for (int i = 0; i < GRAPHITE_NUM_TZS; i++) {
+        int8_t dataidx = get_current_tz_idx(&tzinfo.data[i]);
+        if (dataidx < 0) continue;
+        // the helper asks for new data 100 seconds before expiration
+        time_t check = tzinfo.data[i].untils[dataidx] - 100;
+        if (check > now && (next == 0 || check < next)) next = check;
+    }
+    if (next != 0) {
+        schedule_task(TASK_TZ, MIN(next - now, GRAPHITE_SCHEDULER_MAX_DELAY_MS / 1000) * 1000,
+                      GRAPHITE_SCHEDULER_FETCH_SLACK_MS, check_update_tz_timer);
+    } else {
+        cancel_task(TASK_TZ);
+    }
+}
+
 void check_update_tz() {
 // -- autogen
 // -- ## for i in range(num_tzs)
@@ -159,41 +321,26 @@ void check_update_tz() {
     check_update_tz_helper(1, MSG_KEY_FETCH_TZ_1);
     check_update_tz_helper(2, MSG_KEY_FETCH_TZ_2);
 // -- end autogen
+    schedule_tz_check();
 }
 
 /**
- * Helpers to process new configuration.
+ * Helpers to stage new configuration values.
  */
-bool sync_helper_uint8_t(const uint32_t key, DictionaryIterator *iter, uint8_t *value) {
+void sync_helper_uint8_t(const uint32_t key, DictionaryIterator *iter, uint8_t *value) {
     Tuple *new_tuple = dict_find(iter, key);
-    if (new_tuple == NULL) return false;
-    if ((*value) != new_tuple->value->uint8) {
-        (*value) = new_tuple->value->uint8;
-        persist_write_int(key, *value);
-        return true;
-    }
-    return false;
+    if (new_tuple == NULL) return;
+    (*value) = new_tuple->value->uint8;
 }
-bool sync_helper_uint16_t(const uint32_t key, DictionaryIterator *iter, uint16_t *value) {
+void sync_helper_uint16_t(const uint32_t key, DictionaryIterator *iter, uint16_t *value) {
     Tuple *new_tuple = dict_find(iter, key);
-    if (new_tuple == NULL) return false;
-    if ((*value) != new_tuple->value->uint16) {
-        (*value) = new_tuple->value->uint16;
-        persist_write_int(key, *value);
-        return true;
-    }
-    return false;
+    if (new_tuple == NULL) return;
+    (*value) = new_tuple->value->uint16;
 }
-bool sync_helper_string(const uint32_t key, DictionaryIterator *iter, char *buffer) {
-    int maxlen = GRAPHITE_STRINGCONFIG_MAXLEN;
+void sync_helper_string(const uint32_t key, DictionaryIterator *iter, char *buffer) {
     Tuple *new_tuple = dict_find(iter, key);
-    if (new_tuple == NULL) return false;
-    if (strncmp(buffer, new_tuple->value->cstring, maxlen) != 0) {
-        strncpy(buffer, new_tuple->value->cstring, maxlen);
-        persist_write_string(key, buffer);
-        return true;
-    }
-    return false;
+    if (new_tuple == NULL) return;
+    strncpy(buffer, new_tuple->value->cstring, GRAPHITE_STRINGCONFIG_MAXLEN);
 }
 
 uint32_t decode_bytes_to_int(uint8_t *bytes, uint8_t nbytes) {
@@ -204,6 +351,126 @@ uint32_t decode_bytes_to_int(uint8_t *bytes, uint8_t nbytes) {
     return res;
 }
 
+static uint8_t* encode_int_to_bytes(uint8_t *bytes, uint32_t val, uint8_t nbytes) {
+    for (int i = 0; i < nbytes; i++) {
+        bytes[i] = val & 0xff;
+        val >>= 8;
+    }
+    return bytes + nbytes;
+}
+
+static uint32_t read_bytes(uint8_t **cursor, uint8_t nbytes) {
+    uint32_t res = decode_bytes_to_int(*cursor, nbytes);
+    *cursor += nbytes;
+    return res;
+}
+
+/**
+ * Persisted formats for weather, phone battery and timezone data.  The in-memory structs are aligned
+ * for fast access, so they are explicitly serialized here.  The layouts are byte-for-byte the same as
+ * the packed structs used by earlier versions, so existing data stays readable.
+ */
+#define GRAPHITE_WEATHER_PERSIST_LEN (1 + 4 + 1 + 3*2 + GRAPHITE_WEATHER_PERC_MAX_LEN + 1 + 3*4 + 1)
+#define GRAPHITE_PHONE_BATTERY_PERSIST_LEN (1 + 1 + 4)
+#define GRAPHITE_TZ_PERSIST_LEN (2 + GRAPHITE_NUM_TZS * (1 + GRAPHITE_TZ_MAX_DATAPOINTS * (4 + 2)))
+
+static void persist_write_weather() {
+    uint8_t data[GRAPHITE_WEATHER_PERSIST_LEN];
+    uint8_t *p = data;
+    p = encode_int_to_bytes(p, GRAPHITE_WEATHER_VERSION, 1);
+    p = encode_int_to_bytes(p, weather.timestamp, 4);
+    p = encode_int_to_bytes(p, weather.icon, 1);
+    p = encode_int_to_bytes(p, weather.temp_cur, 2);
+    p = encode_int_to_bytes(p, weather.temp_low, 2);
+    p = encode_int_to_bytes(p, weather.temp_high, 2);
+    memcpy(p, weather.perc_data, GRAPHITE_WEATHER_PERC_MAX_LEN);
+    p += GRAPHITE_WEATHER_PERC_MAX_LEN;
+    p = encode_int_to_bytes(p, weather.perc_data_len, 1);
+    p = encode_int_to_bytes(p, weather.perc_data_ts, 4);
+    p = encode_int_to_bytes(p, weather.sunrise, 4);
+    p = encode_int_to_bytes(p, weather.sunset, 4);
+    p = encode_int_to_bytes(p, weather.failed, 1);
+    persist_write_data(PERSIST_KEY_WEATHER, data, sizeof(data));
+}
+
+static bool persist_read_weather() {
+    uint8_t data[GRAPHITE_WEATHER_PERSIST_LEN];
+    if (!persist_exists(PERSIST_KEY_WEATHER) || persist_get_size(PERSIST_KEY_WEATHER) != sizeof(data)) return false;
+    persist_read_data(PERSIST_KEY_WEATHER, data, sizeof(data));
+    uint8_t *p = data;
+    // make sure we are reading weather info that's consistent with the current version number
+    if (read_bytes(&p, 1) != GRAPHITE_WEATHER_VERSION) return false;
+    weather.timestamp = read_bytes(&p, 4);
+    weather.icon = read_bytes(&p, 1);
+    weather.temp_cur = read_bytes(&p, 2);
+    weather.temp_low = read_bytes(&p, 2);
+    weather.temp_high = read_bytes(&p, 2);
+    memcpy(weather.perc_data, p, GRAPHITE_WEATHER_PERC_MAX_LEN);
+    p += GRAPHITE_WEATHER_PERC_MAX_LEN;
+    weather.perc_data_len = read_bytes(&p, 1);
+    weather.perc_data_ts = read_bytes(&p, 4);
+    weather.sunrise = read_bytes(&p, 4);
+    weather.sunset = read_bytes(&p, 4);
+    weather.failed = read_bytes(&p, 1);
+    return true;
+}
+
+static void persist_write_phonebat() {
+    uint8_t data[GRAPHITE_PHONE_BATTERY_PERSIST_LEN];
+    uint8_t *p = data;
+    p = encode_int_to_bytes(p, GRAPHITE_PHONE_BATTERY_VERSION, 1);
+    p = encode_int_to_bytes(p, phonebat.level, 1);
+    p = encode_int_to_bytes(p, phonebat.timestamp, 4);
+    persist_write_data(PERSIST_KEY_PHONEBAT, data, sizeof(data));
+}
+
+static bool persist_read_phonebat() {
+    uint8_t data[GRAPHITE_PHONE_BATTERY_PERSIST_LEN];
+    if (!persist_exists(PERSIST_KEY_PHONEBAT) || persist_get_size(PERSIST_KEY_PHONEBAT) != sizeof(data)) return false;
+    persist_read_data(PERSIST_KEY_PHONEBAT, data, sizeof(data));
+    uint8_t *p = data;
+    // make sure we are reading phonebat info that's consistent with the current version number
+    if (read_bytes(&p, 1) != GRAPHITE_PHONE_BATTERY_VERSION) return false;
+    phonebat.level = read_bytes(&p, 1);
+    phonebat.timestamp = read_bytes(&p, 4);
+    return true;
+}
+
+static void persist_write_tz() {
+    uint8_t data[GRAPHITE_TZ_PERSIST_LEN];
+    uint8_t *p = data;
+    p = encode_int_to_bytes(p, GRAPHITE_TZ_DATA_VERSION, 2);
+    for (int i = 0; i < GRAPHITE_NUM_TZS; i++) {
+        p = encode_int_to_bytes(p, tzinfo.data[i].valid, 1);
+        for (int j = 0; j < GRAPHITE_TZ_MAX_DATAPOINTS; j++) {
+            p = encode_int_to_bytes(p, tzinfo.data[i].untils[j], 4);
+        }
+        for (int j = 0; j < GRAPHITE_TZ_MAX_DATAPOINTS; j++) {
+            p = encode_int_to_bytes(p, tzinfo.data[i].offsets[j], 2);
+        }
+    }
+    persist_write_data(PERSIST_KEY_TZ, data, sizeof(data));
+}
+
+static bool persist_read_tz() {
+    uint8_t data[GRAPHITE_TZ_PERSIST_LEN];
+    if (!persist_exists(PERSIST_KEY_TZ) || persist_get_size(PERSIST_KEY_TZ) != sizeof(data)) return false;
+    persist_read_data(PERSIST_KEY_TZ, data, sizeof(data));
+    uint8_t *p = data;
+    // make sure we are reading tz info that's consistent with the current version number
+    if (read_bytes(&p, 2) != GRAPHITE_TZ_DATA_VERSION) return false;
+    for (int i = 0; i < GRAPHITE_NUM_TZS; i++) {
+        tzinfo.data[i].valid = read_bytes(&p, 1);
+        for (int j = 0; j < GRAPHITE_TZ_MAX_DATAPOINTS; j++) {
+            tzinfo.data[i].untils[j] = read_bytes(&p, 4);
+        }
+        for (int j = 0; j < GRAPHITE_TZ_MAX_DATAPOINTS; j++) {
+            tzinfo.data[i].offsets[j] = read_bytes(&p, 2);
+        }
+    }
+    return true;
+}
+
 bool sync_tz(uint8_t idx, const uint32_t key, DictionaryIterator *iter) {
     Tuple *tz_data;
     tz_data = dict_find(iter, key);
@@ -233,13 +500,167 @@ bool sync_tz(uint8_t idx, const uint32_t key, DictionaryIterator *iter) {
             tzinfo.data[idx].untils[i] = 0;
             i += 1;
         }
-        tzinfo.version = GRAPHITE_TZ_DATA_VERSION;
-        persist_write_data(PERSIST_KEY_TZ, &tzinfo, sizeof(TimeZoneInfo));
+        persist_write_tz();
         return true;
     }
     return false;
 }
 
+/**
+ * Fletcher-16 checksum of a precipitation series (the phone computes the same, see sendWeather).
+ */
+static uint16_t perc_checksum(const uint8_t *data, uint8_t len) {
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    for (int i = 0; i < len; i++) {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+/**
+ * Apply a precipitation delta: shift the series we have to the new start time, and patch the hours that changed.
+ */
+static bool apply_perc_delta(uint8_t *data, uint16_t length, time_t perc_data_ts, uint8_t perc_data_len) {
+    const uint8_t *delta = data + GRAPHITE_WEATHER_PAYLOAD_HEADER_LEN;
+    if (length < GRAPHITE_WEATHER_PAYLOAD_HEADER_LEN + GRAPHITE_WEATHER_PAYLOAD_DELTA_HEADER_LEN) return false;
+    uint8_t count = delta[6];
+    if (length < GRAPHITE_WEATHER_PAYLOAD_HEADER_LEN + GRAPHITE_WEATHER_PAYLOAD_DELTA_HEADER_LEN + 2 * count) return false;
+
+    // make sure we have the series the delta is based on
+    time_t base_ts = (int32_t)decode_bytes_to_int((uint8_t *)delta, 4);
+    uint16_t checksum = decode_bytes_to_int((uint8_t *)delta + 4, 2);
+    if (weather.timestamp == 0 || weather.perc_data_ts != base_ts ||
+        perc_checksum(weather.perc_data, weather.perc_data_len) != checksum) return false;
+    if (perc_data_ts < base_ts || (perc_data_ts - base_ts) % (60*60) != 0) return false;
+    for (int i = 0; i < count; i++) {
+        if (delta[GRAPHITE_WEATHER_PAYLOAD_DELTA_HEADER_LEN + 2 * i] >= perc_data_len) return false;
+    }
+
+    int shift = (perc_data_ts - base_ts) / (60*60);
+    int kept = weather.perc_data_len > shift ? weather.perc_data_len - shift : 0;
+    if (kept > 0) {
+        memmove(weather.perc_data, weather.perc_data + shift, kept);
+    }
+    if (kept < GRAPHITE_WEATHER_PERC_MAX_LEN) {
+        memset(weather.perc_data + kept, 0, GRAPHITE_WEATHER_PERC_MAX_LEN - kept);
+    }
+    for (int i = 0; i < count; i++) {
+        const uint8_t *patch = delta + GRAPHITE_WEATHER_PAYLOAD_DELTA_HEADER_LEN + 2 * i;
+        weather.perc_data[patch[0]] = patch[1];
+    }
+    weather.perc_data_ts = perc_data_ts;
+    weather.perc_data_len = perc_data_len;
+    return true;
+}
+
+/**
+ * Apply a weather update (see weather_payload_* in scripts/initialize.py), which was fetched by the phone at the
+ * given time.
+ */
+bool sync_weather(uint8_t *data, uint16_t length, time_t fetched) {
+    if (length < GRAPHITE_WEATHER_PAYLOAD_HEADER_LEN) return false;
+    bool is_delta = data[0] == GRAPHITE_WEATHER_PAYLOAD_DELTA_VERSION;
+    if (data[0] != GRAPHITE_WEATHER_PAYLOAD_VERSION && !is_delta) return false;
+    uint8_t perc_data_len = data[20];
+    if (perc_data_len > GRAPHITE_WEATHER_PERC_MAX_LEN) return false;
+    if (!is_delta && length < GRAPHITE_WEATHER_PAYLOAD_HEADER_LEN + perc_data_len) return false;
+
+    Weather prev = weather;
+    time_t perc_data_ts = (int32_t)decode_bytes_to_int(data + 16, 4);
+    if (is_delta) {
+        if (!apply_perc_delta(data, length, perc_data_ts, perc_data_len)) {
+            // we don't have what the phone thinks we have
+            weather_resync_pending = true;
+            return false;
+        }
+    } else {
+        weather.perc_data_ts = perc_data_ts;
+        weather.perc_data_len = perc_data_len;
+        memcpy(weather.perc_data, data + GRAPHITE_WEATHER_PAYLOAD_HEADER_LEN, perc_data_len);
+    }
+    weather.timestamp = fetched;
+    weather.icon = data[1];
+    weather.temp_cur = (int16_t)decode_bytes_to_int(data + 2, 2);
+    weather.temp_low = (int16_t)decode_bytes_to_int(data + 4, 2);
+    weather.temp_high = (int16_t)decode_bytes_to_int(data + 6, 2);
+    weather.sunrise = (int32_t)decode_bytes_to_int(data + 8, 4);
+    weather.sunset = (int32_t)decode_bytes_to_int(data + 12, 4);
+    weather.failed = false;
+    if (fetched >= prev.timestamp) {
+        weather_unchanged = same_weather(&prev, &weather) ? MIN(weather_unchanged + 1, 255) : 0;
+    }
+    weather_failures = 0;
+// -- build=debug
+// --     APP_LOG(APP_LOG_LEVEL_DEBUG, "received weather: temp=%d/%d/%d, len(rain)=%d", weather.temp_low, weather.temp_cur, weather.temp_high, weather.perc_data_len);
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "received weather: temp=%d/%d/%d, len(rain)=%d", weather.temp_low, weather.temp_cur, weather.temp_high, weather.perc_data_len);
+// -- end build
+    persist_write_weather();
+    return true;
+}
+
+/**
+ * Drop the minutes of the nowcast that have passed.
+ */
+void advance_nowcast() {
+    if (nowcast.start == 0) return;
+    time_t now = time(NULL);
+    now -= now % 60;
+    if (now - nowcast.start >= GRAPHITE_NOWCAST_MINUTES * 60) {
+        nowcast.start = 0;
+        return;
+    }
+    while (nowcast.start < now) {
+        // the slot of the minute that passed becomes the last minute of the next hour, which we know nothing about
+        nowcast.data[nowcast.head / 2] &= nowcast.head % 2 ? 0x0f : 0xf0;
+        nowcast.head = (nowcast.head + 1) % GRAPHITE_NOWCAST_MINUTES;
+        nowcast.start += 60;
+    }
+}
+
+/**
+ * The precipitation intensity (0 to GRAPHITE_NOWCAST_MAX_LEVEL) in a given number of minutes from the minute
+ * being drawn.
+ */
+uint8_t nowcast_level(int minute) {
+    if (nowcast.start == 0) return 0;
+    time_t now = frame_time();
+    minute += (now - now % 60 - nowcast.start) / 60;
+    if (minute < 0 || minute >= GRAPHITE_NOWCAST_MINUTES) return 0;
+    int idx = (nowcast.head + minute) % GRAPHITE_NOWCAST_MINUTES;
+    uint8_t byte = nowcast.data[idx / 2];
+    return idx % 2 ? byte >> 4 : byte & 0x0f;
+}
+
+/**
+ * Is there any precipitation in the nowcast?
+ */
+bool nowcast_available() {
+    if (nowcast.start == 0) return false;
+    for (int i = 0; i < GRAPHITE_NOWCAST_MINUTES / 2; i++) {
+        if (nowcast.data[i] != 0) return true;
+    }
+    return false;
+}
+
+static bool sync_nowcast(uint8_t *data, uint16_t length) {
+    if (length < GRAPHITE_NOWCAST_PAYLOAD_HEADER_LEN) return false;
+    uint8_t count = MIN(data[4], GRAPHITE_NOWCAST_MINUTES);
+    if (length < GRAPHITE_NOWCAST_PAYLOAD_HEADER_LEN + (count + 1) / 2) return false;
+    memset(nowcast.data, 0, sizeof(nowcast.data));
+    memcpy(nowcast.data, data + GRAPHITE_NOWCAST_PAYLOAD_HEADER_LEN, (count + 1) / 2);
+    if (count % 2) {
+        // ignore the unused high nibble
+        nowcast.data[count / 2] &= 0x0f;
+    }
+    nowcast.head = 0;
+    nowcast.start = (int32_t)decode_bytes_to_int(data, 4);
+    nowcast.start -= nowcast.start % 60;
+    advance_nowcast();
+    return true;
+}
+
 typedef struct {
     uint8_t key;
     void* var;
@@ -295,6 +716,10 @@ ConfigKeyAddr config_ka_8bit[] = {
     { .key = CONFIG_COLOR_QUIET_MODE, .var = &config_color_quiet_mode },
     { .key = CONFIG_QUIET_COL, .var = &config_quiet_col },
     { .key = CONFIG_UPDATE_PHONEBAT_ON_SHAKE, .var = &config_update_phonebat_on_shake },
+    { .key = CONFIG_PHONE_BATTERY_PUSH, .var = &config_phone_battery_push },
+    { .key = CONFIG_PRERENDER_NEXT_MINUTE, .var = &config_prerender_next_minute },
+    { .key = CONFIG_POWER_SAVER, .var = &config_power_saver },
+    { .key = CONFIG_AMBIENT, .var = &config_ambient },
 // -- end autogen
 };
 ConfigKeyAddr config_ka_16bit[] = {
@@ -330,22 +755,142 @@ ConfigKeyAddr config_ka_string[] = {
 // -- end autogen
 };
 
+/**
+ * Hash (32 bit FNV-1a) over all configuration values.  JS keeps the configuration the watch last
+ * acknowledged together with this hash, and only sends the changed keys as long as the hashes match.
+ */
+static uint32_t hash_bytes(uint32_t hash, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+static uint32_t compute_config_hash() {
+    uint32_t hash = 2166136261u;
+    for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_8bit); i++) {
+        hash = hash_bytes(hash, config_ka_8bit[i].var, 1);
+    }
+    for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_16bit); i++) {
+        hash = hash_bytes(hash, config_ka_16bit[i].var, 2);
+    }
+    for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_string); i++) {
+        hash = hash_bytes(hash, config_ka_string[i].var, strlen(config_ka_string[i].var));
+    }
+    return hash;
+}
 
-void inbox_received_handler(DictionaryIterator *iter, void *context) {
-// -- build=debug
-// --     APP_LOG(APP_LOG_LEVEL_DEBUG, "received message");
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "received message");
-// -- end build
+/**
+ * The configuration arrives in pages (to keep the inbox small).  Values are staged here and only applied
+ * once the last page arrived, so we never run with half a configuration.
+ */
+typedef struct {
+    uint8_t next_page;
+    uint8_t values_8bit[ARRAY_LENGTH(config_ka_8bit)];
+    uint16_t values_16bit[ARRAY_LENGTH(config_ka_16bit)];
+    char values_string[ARRAY_LENGTH(config_ka_string)][GRAPHITE_STRINGCONFIG_MAXLEN+1];
+} ConfigStaging;
+static ConfigStaging *config_staging = NULL;
 
+static void stage_config_page(DictionaryIterator *iter, uint8_t page) {
+    if (page == 0) {
+        // (re)start a transfer from the current configuration
+        if (!config_staging) config_staging = malloc(sizeof(ConfigStaging));
+        if (!config_staging) return;
+        config_staging->next_page = 0;
+        for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_8bit); i++) {
+            config_staging->values_8bit[i] = *(uint8_t*)config_ka_8bit[i].var;
+        }
+        for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_16bit); i++) {
+            config_staging->values_16bit[i] = *(uint16_t*)config_ka_16bit[i].var;
+        }
+        for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_string); i++) {
+            strncpy(config_staging->values_string[i], config_ka_string[i].var, GRAPHITE_STRINGCONFIG_MAXLEN+1);
+        }
+    }
+    if (!config_staging) return;
+    if (page > config_staging->next_page) {
+        // we missed a page, drop the transfer
+        free(config_staging);
+        config_staging = NULL;
+        return;
+    }
+
+    // pages contain disjoint keys, so a resent page can simply be applied again
+    for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_8bit); i++) {
+        sync_helper_uint8_t(config_ka_8bit[i].key, iter, &config_staging->values_8bit[i]);
+    }
+    for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_16bit); i++) {
+        sync_helper_uint16_t(config_ka_16bit[i].key, iter, &config_staging->values_16bit[i]);
+    }
+    for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_string); i++) {
+        sync_helper_string(config_ka_string[i].key, iter, config_staging->values_string[i]);
+    }
+    if (page == config_staging->next_page) config_staging->next_page += 1;
+}
+
+/**
+ * Apply (and persist) the staged configuration.  Returns true if anything changed.
+ */
+static bool commit_config() {
     bool dirty = false;
     for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_8bit); i++) {
-        dirty |= sync_helper_uint8_t(config_ka_8bit[i].key, iter, config_ka_8bit[i].var);
+        uint8_t *value = config_ka_8bit[i].var;
+        if (*value != config_staging->values_8bit[i]) {
+            *value = config_staging->values_8bit[i];
+            persist_write_int(config_ka_8bit[i].key, *value);
+            dirty = true;
+        }
     }
     for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_16bit); i++) {
-        dirty |= sync_helper_uint16_t(config_ka_16bit[i].key, iter, config_ka_16bit[i].var);
+        uint16_t *value = config_ka_16bit[i].var;
+        if (*value != config_staging->values_16bit[i]) {
+            *value = config_staging->values_16bit[i];
+            persist_write_int(config_ka_16bit[i].key, *value);
+            dirty = true;
+        }
     }
     for (unsigned i = 0; i < ARRAY_LENGTH(config_ka_string); i++) {
-        dirty |= sync_helper_string(config_ka_string[i].key, iter, config_ka_string[i].var);
+        char *buffer = config_ka_string[i].var;
+        if (strncmp(buffer, config_staging->values_string[i], GRAPHITE_STRINGCONFIG_MAXLEN) != 0) {
+            strncpy(buffer, config_staging->values_string[i], GRAPHITE_STRINGCONFIG_MAXLEN);
+            persist_write_string(config_ka_string[i].key, buffer);
+            dirty = true;
+        }
+    }
+    free(config_staging);
+    config_staging = NULL;
+    return dirty;
+}
+
+
+void inbox_received_handler(DictionaryIterator *iter, void *context) {
+// -- build=debug
+// --     APP_LOG(APP_LOG_LEVEL_DEBUG, "received message");
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "received message");
+// -- end build
+
+    // the message may update the persisted data, so it has to be read first if the startup isn't that far yet
+    read_persisted_data();
+
+    bool dirty = false;
+    Tuple *page_tuple = dict_find(iter, MSG_KEY_CONFIG_PAGE);
+    if (page_tuple) {
+        stage_config_page(iter, page_tuple->value->uint8);
+        if (!dict_find(iter, MSG_KEY_CONFIG_LAST)) {
+            // wait for the remaining pages
+            return;
+        }
+        if (!config_staging) {
+            // we missed a page (or had no memory to stage it), ask JS to send the configuration again
+            config_failed_pending = true;
+        } else {
+            if (commit_config()) {
+                dirty = true;
+                config_hash = compute_config_hash();
+            }
+            // acknowledge the configuration with our (possibly new) hash
+            config_hash_pending = true;
+        }
     }
 
     bool ask_for_weather_update = true;
@@ -353,59 +898,50 @@ void inbox_received_handler(DictionaryIterator *iter, void *context) {
     bool force_weather_update = true;
     bool force_phonebat_update = true;
 
-    Tuple *icon_tuple = dict_find(iter, MSG_KEY_WEATHER_ICON_CUR);
-    Tuple *tempcur_tuple = dict_find(iter, MSG_KEY_WEATHER_TEMP_CUR);
-    Tuple *templow_tuple = dict_find(iter, MSG_KEY_WEATHER_TEMP_LOW);
-    Tuple *temphigh_tuple = dict_find(iter, MSG_KEY_WEATHER_TEMP_HIGH);
-    Tuple *perc_data_tuple = dict_find(iter, MSG_KEY_WEATHER_PERC_DATA);
-    Tuple *perc_data_ts_tuple = dict_find(iter, MSG_KEY_WEATHER_PERC_DATA_TS);
-    Tuple *perc_data_len_tuple = dict_find(iter, MSG_KEY_WEATHER_PERC_DATA_LEN);
-    Tuple *sunrise_tuple = dict_find(iter, MSG_KEY_WEATHER_SUNRISE);
-    Tuple *sunset_tuple = dict_find(iter, MSG_KEY_WEATHER_SUNSET);
-    if (icon_tuple && tempcur_tuple && templow_tuple && temphigh_tuple) {
-        weather.version = GRAPHITE_WEATHER_VERSION;
-        weather.timestamp = time(NULL);
-        weather.icon = icon_tuple->value->int8;
-        weather.temp_cur = tempcur_tuple->value->int16;
-        weather.temp_low = templow_tuple->value->int16;
-        weather.temp_high = temphigh_tuple->value->int16;
-
-        if (perc_data_tuple && perc_data_ts_tuple && perc_data_len_tuple) {
-            weather.perc_data_len = perc_data_len_tuple->value->uint8;
-            weather.perc_data_ts = perc_data_ts_tuple->value->int32;
-            for (int i = 0; i < weather.perc_data_len && i < GRAPHITE_WEATHER_PERC_MAX_LEN; i++) {
-                weather.perc_data[i] = perc_data_tuple->value->data[i];
-            }
-        } else {
-            weather.perc_data_len = 0;
-            weather.perc_data_ts = 0;
-        }
-
-        if (sunrise_tuple && sunset_tuple) {
-            weather.sunrise = sunrise_tuple->value->int32;
-            weather.sunset = sunset_tuple->value->int32;
-        } else {
-            weather.sunrise = 0;
-            weather.sunset = 0;
-        }
+    // when JS starts, it sends what it has along with its age (see warm_start_* in scripts/initialize.py)
+    time_t now = time(NULL);
+    time_t weather_fetched = now;
+    time_t phonebat_fetched = now;
+    Tuple *warm_tuple = dict_find(iter, MSG_KEY_WARM_START);
+    if (warm_tuple && warm_tuple->length >= GRAPHITE_WARM_START_PAYLOAD_LEN) {
+        uint32_t weather_age = decode_bytes_to_int(warm_tuple->value->data, 4);
+        uint32_t phonebat_age = decode_bytes_to_int(warm_tuple->value->data + 4, 4);
+        if (weather_age != GRAPHITE_WARM_START_UNKNOWN_AGE) weather_fetched = now - (time_t)weather_age;
+        if (phonebat_age != GRAPHITE_WARM_START_UNKNOWN_AGE) phonebat_fetched = now - (time_t)phonebat_age;
+    }
 
-        weather.failed = false;
-        persist_write_data(PERSIST_KEY_WEATHER, &weather, sizeof(Weather));
+    Tuple *weather_tuple = dict_find(iter, MSG_KEY_WEATHER);
+    if (weather_tuple && weather.timestamp > weather_fetched && !weather.failed) {
+        // we already have more recent weather than the phone's cache (which the phone revalidates on its own)
+        weather_tuple = NULL;
+        ask_for_weather_update = false;
+        ask_for_phonebat_update= false;
+    }
+    if (weather_tuple && sync_weather(weather_tuple->value->data, weather_tuple->length, weather_fetched)) {
         dirty = true;
         ask_for_weather_update = false;
         ask_for_phonebat_update= false;
+        // the nowcast comes with the weather (if the weather source provides it)
+        Tuple *nowcast_tuple = dict_find(iter, MSG_KEY_NOWCAST);
+        if (!nowcast_tuple || !sync_nowcast(nowcast_tuple->value->data, nowcast_tuple->length)) {
+            nowcast.start = 0;
+        }
     }
     Tuple *phonebat_tuple = dict_find(iter, MSG_KEY_PHONEBAT);
     if (phonebat_tuple) {
-        phonebat.timestamp = time(NULL);
-        phonebat.level = phonebat_tuple->value->uint8;
+        uint8_t level = phonebat_tuple->value->uint8;
+        phonebat_unchanged = (phonebat.timestamp != 0 && phonebat.level == level) ? MIN(phonebat_unchanged + 1, 255) : 0;
+        phonebat.timestamp = phonebat_fetched;
+        phonebat.level = level;
+        persist_write_phonebat();
         dirty = true;
         ask_for_phonebat_update= false;
         ask_for_weather_update = false;
     }
     if (dict_find(iter, MSG_KEY_WEATHER_FAILED)) {
-        // retry early when weather update failed
-        set_weather_timer(config_weather_refresh_failed);
+        // retry early when weather update failed, backing off if it keeps failing
+        weather_failures = MIN(weather_failures + 1, 255);
+        set_weather_timer(backoff_interval());
         ask_for_weather_update = false;
         ask_for_phonebat_update= false;
         weather.failed = true;
@@ -425,19 +961,30 @@ void inbox_received_handler(DictionaryIterator *iter, void *context) {
     ) { dirty = true; ask_for_tz_update = false; }
 // -- end autogen
     if (!ask_for_tz_update) {
+        schedule_tz_check();
         ask_for_weather_update = false;
         ask_for_phonebat_update = false;
     }
 
     if (dict_find(iter, MSG_KEY_JS_READY)) {
         js_ready = true;
+        // whatever came along is tagged with its age, only fetch what is still outdated
+        ask_for_weather_update = true;
+        ask_for_phonebat_update = true;
+        ask_for_tz_update = true;
         force_weather_update = false;
         force_phonebat_update = false;
+        // tell JS which configuration we have
+        config_hash_pending = true;
     }
     if (dirty) {
         // make sure we update tick frequency if necessary
+        update_power_saver();
+        update_ambient_mode();
         subscribe_tick(true);
         subscribe_tap();
+        update_fonts();
+        prerender_invalidate();
         layer_mark_dirty(layer_background);
     }
     if (ask_for_weather_update) {
@@ -449,6 +996,10 @@ void inbox_received_handler(DictionaryIterator *iter, void *context) {
     if (ask_for_tz_update) {
         check_update_tz();
     }
+    if (piggyback_pending()) {
+        // none of the requests above carried the hash (or resync request, or lost configuration)
+        send_message(0);
+    }
 }
 
 /**
@@ -492,49 +1043,30 @@ void read_config_all() {
         read_config_string(config_ka_string[i].key, config_ka_string[i].var);
     }
 
-    if (persist_exists(PERSIST_KEY_WEATHER) && persist_get_size(PERSIST_KEY_WEATHER) == sizeof(Weather)) {
-        Weather tmp;
-        persist_read_data(PERSIST_KEY_WEATHER, &tmp, sizeof(Weather));
-        // make sure we are reading weather info that's consistent with the current version number
-        if (tmp.version == GRAPHITE_WEATHER_VERSION) {
-            weather = tmp;
-        } else {
-            weather.timestamp = 0;
-        }
-    } else {
+    config_hash = compute_config_hash();
+    js_ready = false;
+}
+
+static bool persisted_data_read = false;
+
+/**
+ * Read the persisted weather, phone battery and timezone data.  This isn't needed for the first frame, so it
+ * happens during the staged startup (see graphite.c), or as soon as a message arrives that might replace it.
+ */
+void read_persisted_data() {
+    if (persisted_data_read) return;
+    persisted_data_read = true;
+
+    if (!persist_read_weather()) {
         weather.timestamp = 0;
     }
+    nowcast.start = 0;
 
-    if (persist_exists(PERSIST_KEY_PHONEBAT) && persist_get_size(PERSIST_KEY_PHONEBAT) == sizeof(PhoneBattery)) {
-        PhoneBattery tmp;
-        persist_read_data(PERSIST_KEY_PHONEBAT, &tmp, sizeof(PhoneBattery));
-        // make sure we are reading phonebat info that's consistent with the current version number
-        if (tmp.version == GRAPHITE_PHONE_BATTERY_VERSION) {
-            phonebat = tmp;
-        } else {
-            phonebat.timestamp = 0;
-        }
-    } else {
+    if (!persist_read_phonebat()) {
         phonebat.timestamp = 0;
     }
 
-    if (persist_exists(PERSIST_KEY_TZ) && persist_get_size(PERSIST_KEY_TZ) == sizeof(TimeZoneInfo)) {
-        TimeZoneInfo tmp;
-        persist_read_data(PERSIST_KEY_TZ, &tmp, sizeof(TimeZoneInfo));
-        // make sure we are reading tz info that's consistent with the current version number
-        if (tmp.version == GRAPHITE_TZ_DATA_VERSION) {
-            tzinfo = tmp;
-        } else {
-// -- autogen
-// -- ## for i in range(num_tzs)
-// --             tzinfo.data[{{ i }}].valid = false;
-// -- ## endfor
-            tzinfo.data[0].valid = false;
-            tzinfo.data[1].valid = false;
-            tzinfo.data[2].valid = false;
-// -- end autogen
-        }
-    } else {
+    if (!persist_read_tz()) {
 // -- autogen
 // -- ## for i in range(num_tzs)
 // --         tzinfo.data[{{ i }}].valid = false;
@@ -544,6 +1076,4 @@ void read_config_all() {
         tzinfo.data[2].valid = false;
 // -- end autogen
     }
-
-    js_ready = false;
 }
@@ -19,10 +19,23 @@
 
 int8_t get_current_tz_idx(TZData* data);
 void update_weather(bool force);
+void update_phonebat(bool force);
+void check_update_tz();
+void advance_nowcast();
+bool nowcast_available();
+uint8_t nowcast_level(int minute);
 void inbox_received_handler(DictionaryIterator *iter, void *context);
+void outbox_sent_handler(DictionaryIterator *iter, void *context);
+void outbox_failed_handler(DictionaryIterator *iter, AppMessageResult reason, void *context);
 void read_config_all();
+void read_persisted_data();
 void subscribe_tick(bool also_unsubscribe);
+void update_power_saver();
+void update_ambient_mode();
+bool fetches_suspended();
 void subscribe_tap();
 void ask_for_update(uint8_t key);
+bool user_sleeping();
+void startup_frame_drawn();
 
 #endif //GRAPHITE_SETTINGS_H
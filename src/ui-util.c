@@ -15,13 +15,65 @@
 #include "ui-util.h"
 #include "graphite.h"
 
+/**
+ * In the power saver, text in the main font is drawn with the (bitmap) system fonts instead, which is a lot cheaper
+ * than rendering outlines.  top is how far below the top of the text box the capital letters start.
+ */
+typedef struct {
+    const char* key;
+    int16_t size;
+    int16_t top;
+} SystemFont;
+
+static const SystemFont system_fonts[] = {
+    { FONT_KEY_GOTHIC_14_BOLD, 14, 4 },
+    { FONT_KEY_GOTHIC_18_BOLD, 18, 5 },
+    { FONT_KEY_GOTHIC_24_BOLD, 24, 7 },
+    { FONT_KEY_GOTHIC_28_BOLD, 28, 9 },
+    { FONT_KEY_BITHAM_42_BOLD, 42, 10 },
+};
+
+/**
+ * The largest system font that isn't larger than size (or the smallest one).
+ */
+static const SystemFont* system_font(fixed_t size) {
+    const SystemFont* res = &system_fonts[0];
+    for (unsigned i = 1; i < ARRAY_LENGTH(system_fonts); i++) {
+        if (INT_TO_FIXED(system_fonts[i].size) <= size) res = &system_fonts[i];
+    }
+    return res;
+}
+
+static GSize system_string_size(const char *str, const SystemFont* font) {
+    return graphics_text_layout_get_content_size(str, fonts_get_system_font(font->key),
+                                                 GRect(0, 0, 2 * PBL_DISPLAY_WIDTH, 2 * font->size),
+                                                 GTextOverflowModeFill, GTextAlignmentLeft);
+}
+
+static void draw_system_string(FContext *fctx, const char *str, FPoint position, uint8_t color, fixed_t size, GTextAlignment align) {
+    const SystemFont* font = system_font(size);
+    GSize text_size = system_string_size(str, font);
+    int16_t x = FIXED_TO_INT(position.x);
+    if (align == GTextAlignmentCenter) x -= text_size.w / 2;
+    if (align == GTextAlignmentRight) x -= text_size.w;
+    GRect box = GRect(x, FIXED_TO_INT(position.y) - font->top, text_size.w + 1, 2 * font->size);
+    graphics_context_set_text_color(fctx->gctx, COLOR(color));
+    graphics_draw_text(fctx->gctx, str, fonts_get_system_font(font->key), box, GTextOverflowModeFill, GTextAlignmentLeft, NULL);
+}
+
 /**
  * Draw a string with a given font, color, size and position.
  */
 void draw_string(FContext *fctx, const char *str, FPoint position, FFont *font, uint8_t color, fixed_t size, GTextAlignment align) {
+    // fonts are loaded on demand (see fonts.c)
+    if (font == NULL) return;
+    if (power_saver && font == font_main) {
+        draw_system_string(fctx, str, position, color, size, align);
+        return;
+    }
     FPoint pos = position;
     if (font == font_icon) {
-        pos.y += REM(7);
+        pos.y += LAYOUT_ICON_OFFSET;
     }
     fctx_begin_fill(fctx);
     fctx_set_fill_color(fctx, COLOR(color));
@@ -30,7 +82,7 @@ void draw_string(FContext *fctx, const char *str, FPoint position, FFont *font,
     fctx_set_offset(fctx, pos);
     fctx_set_rotation(fctx, 0);
     fctx_set_text_em_height(fctx, font, FIXED_TO_INT(size));
-    fctx_draw_string(fctx, str, font, align, FTextAnchorCapTop);
+    font_draw_string(fctx, str, font, align, FTextAnchorCapTop);
     fctx_end_fill(fctx);
 }
 
@@ -38,7 +90,8 @@ void draw_string(FContext *fctx, const char *str, FPoint position, FFont *font,
  * Measure the width of a string in a particular font.
  */
 fixed_t string_width(FContext *fctx, const char *str, FFont *font, int size) {
-    if (str[0] == 0) return 0;
+    if (str[0] == 0 || font == NULL) return 0;
+    if (power_saver && font == font_main) return INT_TO_FIXED(system_string_size(str, system_font(size)).w);
     fctx_set_text_em_height(fctx, font, FIXED_TO_INT(size));
     return fctx_string_width(fctx, str, font);
 }
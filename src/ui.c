@@ -28,6 +28,13 @@ bool is_obstructed() {
     return full.size.h != partial.size.h || full.size.w != partial.size.w;
 }
 
+/**
+ * How far the time and date are moved up when the bottom of the screen is obstructed (e.g., by a timeline peek).
+ */
+fixed_t time_offset(fixed_t full_height, fixed_t unobstructed_height) {
+    return PBL_DISPLAY_WIDTH != 144 ? 0 : (full_height - unobstructed_height) / 8;
+}
+
 /**
  * Draws a popup about the bluetooth connection
  */
@@ -36,17 +43,17 @@ void bluetooth_popup(FContext* fctx, GContext *ctx, bool connected) {
     if (!show_bluetooth_popup) return;
 #endif
 
-    fixed_t h = FIXED_ROUND(REM(60));
-    fixed_t rh_size = REM(40);
+    fixed_t h = LAYOUT_POPUP_HEIGHT;
+    fixed_t rh_size = LAYOUT_POPUP_ICON_WIDTH;
     draw_rect(fctx, FRect(FPoint(0, 0), FSize(width, h + PIX(2))), GColorBlackARGB8);
     draw_rect(fctx, FRect(FPoint(0, 0), FSize(width, h)), GColorWhiteARGB8);
     draw_rect(fctx, FRect(FPoint(width-rh_size, 0), FSize(rh_size, h)), GColorVividCeruleanARGB8);
 
-    fixed_t fs = REM(23);
+    fixed_t fs = LAYOUT_POPUP_FONTSIZE;
     char *str2 = connected ? "Connected" : "Disconnected";
-    draw_string(fctx, "Bluetooth", FPoint((width - rh_size)/2, REM(7)), font_main, GColorBlackARGB8, fs, GTextAlignmentCenter);
-    draw_string(fctx, str2, FPoint((width - rh_size)/2, REM(35)), font_main, GColorBlackARGB8, fs, GTextAlignmentCenter);
-    draw_string(fctx, connected ? "D" : "B", FPoint(width - REM(20), REM(30)), font_icon, GColorBlackARGB8, REM(30), GTextAlignmentCenter);
+    draw_string(fctx, "Bluetooth", FPoint((width - rh_size)/2, LAYOUT_POPUP_LINE_1_Y), font_main, GColorBlackARGB8, fs, GTextAlignmentCenter);
+    draw_string(fctx, str2, FPoint((width - rh_size)/2, LAYOUT_POPUP_LINE_2_Y), font_main, GColorBlackARGB8, fs, GTextAlignmentCenter);
+    draw_string(fctx, connected ? "D" : "B", FPoint(width - LAYOUT_POPUP_ICON_X, LAYOUT_POPUP_ICON_Y), font_icon, GColorBlackARGB8, LAYOUT_POPUP_ICON_FONTSIZE, GTextAlignmentCenter);
 }
 
 /**
@@ -95,7 +102,7 @@ fixed_t draw_weather(FContext* fctx, bool draw, const char* icon, const char* te
     fixed_t weather_fontsize = (fixed_t)(fontsize * 23 / 20); // 1.15
     fixed_t w1 = string_width(fctx, icon, font_weather, weather_fontsize);
     fixed_t w2 = string_width(fctx, temp, font_main, fontsize);
-    fixed_t sep = w1 == 0 || w2 == 0 ? REM(0) : REM(2);
+    fixed_t sep = w1 == 0 || w2 == 0 ? 0 : LAYOUT_WIDGET_SEP;
     fixed_t w = w1 + w2 + sep;
     GTextAlignment a = GTextAlignmentLeft;
 
@@ -125,7 +132,7 @@ bool show_weather() {
 bool show_weather_impl(uint16_t timeout) {
     bool weather_is_on = config_weather_refresh > 0;
     bool weather_is_available = weather.timestamp > 0;
-    bool weather_is_outdated = (time(NULL) - weather.timestamp) > (timeout * 60);
+    bool weather_is_outdated = (frame_time() - weather.timestamp) > (timeout * 60);
     bool show_weather = weather_is_on && weather_is_available && !weather_is_outdated;
     return show_weather;
 }
@@ -133,7 +140,7 @@ bool show_weather_impl(uint16_t timeout) {
 fixed_t find_fontsize(FContext* fctx, fixed_t target, fixed_t min, const char* str) {
     fixed_t l = min;
     fixed_t h = target;
-    fixed_t border = REM(20);
+    fixed_t border = LAYOUT_FONTSIZE_BORDER;
     if (string_width(fctx, str, font_main, target) <= width - border) {
         return target;
     }
@@ -151,6 +158,24 @@ fixed_t find_fontsize(FContext* fctx, fixed_t target, fixed_t min, const char* s
     return l;
 }
 
+/**
+ * Draw a set of widgets: three in the top bar, and three at the bottom (at height bottom_y).
+ */
+void draw_widget_rows(FContext* fctx, uint8_t w1, uint8_t w2, uint8_t w3, uint8_t w4, uint8_t w5, uint8_t w6, fixed_t bottom_y, uint8_t topbar_color) {
+    fixed_t widgets_margin_topbottom = LAYOUT_WIDGETS_MARGIN_TOPBOTTOM; // gap between watch bounds and widgets
+    fixed_t widgets_margin_leftright = LAYOUT_WIDGETS_MARGIN_LEFTRIGHT;
+
+    // top widgets
+    widgets[w1](fctx, true, FPoint(widgets_margin_leftright, widgets_margin_topbottom), GTextAlignmentLeft, config_color_widget_1, topbar_color);
+    widgets[w2](fctx, true, FPoint(width / 2, widgets_margin_topbottom), GTextAlignmentCenter, config_color_widget_2, topbar_color);
+    widgets[w3](fctx, true, FPoint(width - widgets_margin_leftright, widgets_margin_topbottom), GTextAlignmentRight, config_color_widget_3, topbar_color);
+
+    // bottom widgets
+    widgets[w4](fctx, true, FPoint(widgets_margin_leftright, bottom_y), GTextAlignmentLeft, config_color_widget_4, config_color_background);
+    widgets[w5](fctx, true, FPoint(width / 2, bottom_y), GTextAlignmentCenter, config_color_widget_5, config_color_background);
+    widgets[w6](fctx, true, FPoint(width - widgets_margin_leftright, bottom_y), GTextAlignmentRight, config_color_widget_6, config_color_background);
+}
+
 /**
  * Draw the watch face.
  */
@@ -159,6 +184,12 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     // initialize fctx
     FContext fctx_obj;
     FContext* fctx = &fctx_obj;
+// -- jsalternative
+#if defined(PBL_COLOR)
+    // the power saver draws without anti-aliasing; this has to be decided before the context is set up
+    fctx_enable_aa(!power_saver);
+#endif
+// -- end jsalternative
     fctx_init_context(fctx, ctx);
 
 //    APP_LOG(APP_LOG_LEVEL_DEBUG, "drawing...");
@@ -169,13 +200,10 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     width = bounds.size.w;
     FRect bounds_full = g2frect(layer_get_bounds(layer_background));
     height_full = bounds_full.size.h;
-// -- autogen
-// --     fontsize_widgets = REM({{ fontsize_widgets }});
-    fontsize_widgets = REM(27);
-// -- end autogen
+    fontsize_widgets = LAYOUT_FONTSIZE_WIDGETS;
 
     // get current time
-    time_t now = time(NULL);
+    time_t now = frame_time();
     struct tm *t = localtime(&now);
 
     // battery status color change
@@ -221,15 +249,34 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     draw_rect(fctx, bounds_full, config_color_background);
 
     // top bar
-    fixed_t fontsize_weather = fontsize_widgets;
-    fixed_t topbar_height = FIXED_ROUND(fontsize_weather + REM(4));
-    draw_rect(fctx, FRect(bounds.origin, FSize(width, topbar_height)), config_color_topbar_bg_local);
-
-    // rain preview
-    if (show_weather()) {
+    fixed_t topbar_height = LAYOUT_TOPBAR_HEIGHT;
+// -- jsalternative
+// --     var frozen = false;
+    // in ambient mode, the top bar, rain preview and widgets are frozen (see prerender.c)
+    bool frozen = ambient_mode && prerender_frozen_valid();
+    if (frozen) prerender_frozen_draw_top(ctx);
+// -- end jsalternative
+    if (!frozen) draw_rect(fctx, FRect(bounds.origin, FSize(width, topbar_height)), config_color_topbar_bg_local);
+
+    // rain preview (not in the power saver)
+    fixed_t chart_bottom = topbar_height;
+    if (show_weather() && !power_saver && !frozen) {
+        // minute-by-minute strip for the next hour, above the hourly bars
+        fixed_t nowcast_h = nowcast_available() ? LAYOUT_NOWCAST_HEIGHT : 0;
+        if (nowcast_h != 0) {
+            for (int i = 0; i < GRAPHITE_NOWCAST_MINUTES; i++) {
+                uint8_t level = nowcast_level(i);
+                if (level == 0) continue;
+                fixed_t x = width * i / GRAPHITE_NOWCAST_MINUTES;
+                fixed_t w = width * (i + 1) / GRAPHITE_NOWCAST_MINUTES - x;
+                FSize size = FSize(w, nowcast_h * level / GRAPHITE_NOWCAST_MAX_LEVEL);
+                draw_rect(fctx, FRect(FPoint(x, topbar_height), size), config_color_perc);
+            }
+        }
+        chart_bottom = topbar_height + nowcast_h;
         int first_perc_index = -1;
         const int sec_in_hour = 60*60;
-        time_t cur_h_ts = time(NULL);
+        time_t cur_h_ts = frame_time();
         cur_h_ts -= cur_h_ts % sec_in_hour; // align with hour
         for (int i = 0; i < weather.perc_data_len; i++) {
             if (cur_h_ts == weather.perc_data_ts + i * sec_in_hour) {
@@ -253,26 +300,27 @@ void background_update_proc(Layer *layer, GContext *ctx) {
 // --     first_perc_index = 0;
 // -- end jsalternative
         if (first_perc_index != -1 && !all_zero) {
-            fixed_t perc_ti_h = config_show_daynight ? FIXED_ROUND(REM(3)) : 0;
-            fixed_t perc_sep = REM(2); // space between two bars
+            fixed_t perc_ti_h = config_show_daynight ? LAYOUT_RAIN_INDICATOR_HEIGHT : 0;
+            fixed_t perc_sep = LAYOUT_RAIN_BAR_SEP; // space between two bars
             fixed_t perc_bar = (width - (nHours + 1) * perc_sep) / nHours; // width of a single bar (without space)
             fixed_t perc_w = perc_sep + perc_bar; // total width occupied by a single hour
-            fixed_t perc_maxheight = REM(20); // max height of the precipitation bar
+            fixed_t perc_maxheight = LAYOUT_RAIN_BAR_MAXHEIGHT; // max height of the precipitation bar
             fixed_t perc_minoffset = - perc_w * (t->tm_min % 60) / 60; // x axis offset into the current hour
+            chart_bottom = topbar_height + nowcast_h + perc_ti_h + perc_maxheight;
             for (int i = 0; i < nHours + 1; i++) {
                 uint8_t i_percip_prob = 0;
                 if (first_perc_index + i < weather.perc_data_len) {
                     i_percip_prob = weather.perc_data[first_perc_index + i];
                 }
-                FPoint point = FPoint(perc_minoffset + perc_sep / 2 + i * perc_w, topbar_height + perc_ti_h);
+                FPoint point = FPoint(perc_minoffset + perc_sep / 2 + i * perc_w, topbar_height + nowcast_h + perc_ti_h);
                 FSize size = FSize(perc_bar, perc_maxheight * i_percip_prob / 100);
                 draw_rect(fctx, FRect(point, size), config_color_perc);
             }
             // rain preview time indicator
             if (config_show_daynight) {
-                draw_rect(fctx, FRect(FPoint(0, topbar_height), FSize(width, perc_ti_h)), config_color_day);
+                draw_rect(fctx, FRect(FPoint(0, topbar_height + nowcast_h), FSize(width, perc_ti_h)), config_color_day);
                 for (int i = -1; i < 2; i++) {
-                    FPoint point = FPoint(perc_minoffset + (24*i + 18 - t->tm_hour) * perc_w, topbar_height);
+                    FPoint point = FPoint(perc_minoffset + (24*i + 18 - t->tm_hour) * perc_w, topbar_height + nowcast_h);
                     draw_rect(fctx, FRect(point, FSize(12 * perc_w, perc_ti_h)), config_color_night);
                 }
             }
@@ -280,7 +328,7 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     }
 
     // time
-    fixed_t time_y_offset = PBL_DISPLAY_WIDTH != 144 ? 0 : (height_full-height) / 8;
+    fixed_t time_y_offset = time_offset(height_full, height);
     setlocale(LC_ALL, "");
     strftime(buffer_1, sizeof(buffer_1), config_time_format, t);
 // -- jsalternative
@@ -288,8 +336,18 @@ void background_update_proc(Layer *layer, GContext *ctx) {
 // -- end jsalternative
     remove_leading_zero(buffer_1, sizeof(buffer_1));
     fixed_t fontsize_time = (fixed_t)(width * 9/20); // 1/2.2
-    fixed_t fontsize_time_real = find_fontsize(fctx, fontsize_time, REM(15), buffer_1);
-    draw_string(fctx, buffer_1, FPoint(width / 2, height_full / 2 - fontsize_time_real / 2 - time_y_offset), font_main, config_color_time, fontsize_time_real, GTextAlignmentCenter);
+    fixed_t fontsize_time_real = find_fontsize(fctx, fontsize_time, LAYOUT_FONTSIZE_MIN, buffer_1);
+    fixed_t time_y = height_full / 2 - fontsize_time_real / 2 - time_y_offset;
+    draw_string(fctx, buffer_1, FPoint(width / 2, time_y), font_main, config_color_time, fontsize_time_real, GTextAlignmentCenter);
+
+// -- jsalternative
+    // the first frame after startup only shows the time, the rest follows (see startup_continue)
+    if (startup_stage == STARTUP_FIRST_FRAME) {
+        startup_frame_drawn();
+        fctx_deinit_context(fctx);
+        return;
+    }
+// -- end jsalternative
 
     // date
     strftime(buffer_1, sizeof(buffer_1), config_info_below, t);
@@ -297,9 +355,10 @@ void background_update_proc(Layer *layer, GContext *ctx) {
 // --     buffer_1 = 
 // -- end jsalternative
     remove_leading_zero(buffer_1, sizeof(buffer_1));
-    fixed_t fontsize_date = REM(28);
-    fixed_t fontsize_date_real = find_fontsize(fctx, fontsize_date, REM(15), buffer_1);
-    draw_string(fctx, buffer_1, FPoint(width / 2, height_full / 2 + fontsize_time / 3 - time_y_offset), font_main, config_color_info_below_local, fontsize_date_real, GTextAlignmentCenter);
+    fixed_t fontsize_date = LAYOUT_FONTSIZE_DATE;
+    fixed_t fontsize_date_real = find_fontsize(fctx, fontsize_date, LAYOUT_FONTSIZE_MIN, buffer_1);
+    fixed_t date_y = height_full / 2 + fontsize_time / 3 - time_y_offset;
+    draw_string(fctx, buffer_1, FPoint(width / 2, date_y), font_main, config_color_info_below_local, fontsize_date_real, GTextAlignmentCenter);
 
     // progress bar
     int progress_cur = 0;
@@ -314,7 +373,7 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     }
     if (progress_max == 0) progress_max = 1;
 
-    fixed_t progress_height = REM(5);
+    fixed_t progress_height = LAYOUT_PROGRESS_HEIGHT;
     fixed_t progress_endx = width * progress_cur / progress_max;
     if (!progress_no) {
         draw_rect(fctx, FRect(FPoint(0, height_full - progress_height), FSize(progress_endx, progress_height)), config_color_progress_bar_local);
@@ -326,13 +385,14 @@ void background_update_proc(Layer *layer, GContext *ctx) {
         }
     }
 
+    bool secondary = show_secondary_widgets && config_2nd_widgets;
     uint8_t w1 = config_widget_1;
     uint8_t w2 = config_widget_2;
     uint8_t w3 = config_widget_3;
     uint8_t w4 = config_widget_4;
     uint8_t w5 = config_widget_5;
     uint8_t w6 = config_widget_6;
-    if (show_secondary_widgets && config_2nd_widgets) {
+    if (secondary) {
         w1 = config_widget_7;
         w2 = config_widget_8;
         w3 = config_widget_9;
@@ -341,19 +401,56 @@ void background_update_proc(Layer *layer, GContext *ctx) {
         w6 = config_widget_12;
     }
 
-    // top widgets
-    fixed_t widgets_margin_topbottom = REM(6); // gap between watch bounds and widgets
-    fixed_t widgets_margin_leftright = REM(8);
-    widgets[w1](fctx, true, FPoint(widgets_margin_leftright, widgets_margin_topbottom), GTextAlignmentLeft, config_color_widget_1, config_color_topbar_bg_local);
-    widgets[w2](fctx, true, FPoint(width / 2, widgets_margin_topbottom), GTextAlignmentCenter, config_color_widget_2, config_color_topbar_bg_local);
-    widgets[w3](fctx, true, FPoint(width - widgets_margin_leftright, widgets_margin_topbottom), GTextAlignmentRight, config_color_widget_3, config_color_topbar_bg_local);
-
-    // bottom widgets
+    // widgets
     fixed_t compl_y = height_full - fontsize_widgets;
-    fixed_t compl_y2 = compl_y - progress_height + REM(1);
-    widgets[w4](fctx, true, FPoint(widgets_margin_leftright, progress_no ? compl_y : compl_y2), GTextAlignmentLeft, config_color_widget_4, config_color_background);
-    widgets[w5](fctx, true, FPoint(width / 2, progress_no ? compl_y : compl_y2), GTextAlignmentCenter, config_color_widget_5, config_color_background);
-    widgets[w6](fctx, true, FPoint(width - widgets_margin_leftright, progress_no ? compl_y : compl_y2), GTextAlignmentRight, config_color_widget_6, config_color_background);
+    fixed_t compl_y2 = compl_y - progress_height + LAYOUT_PROGRESS_OVERLAP;
+    fixed_t widgets_y = progress_no ? compl_y : compl_y2;
+// -- jsalternative
+    // nothing but the time and date moves while the screen gets obstructed, so during the timeline peek animation
+    // only this band is moved around (see prerender_peek_frame)
+    int16_t clip_top = FIXED_TO_INT(chart_bottom) + 1;
+    int16_t clip_bottom = FIXED_TO_INT(widgets_y - LAYOUT_WIDGETS_BOTTOM_PADDING);
+    int16_t band_top = FIXED_TO_INT(time_y) - 1;
+    int16_t band_bottom = FIXED_TO_INT(date_y + fontsize_date_real) + 1;
+    if (band_top < clip_top) band_top = clip_top;
+    if (band_bottom > clip_bottom) band_bottom = clip_bottom;
+    prerender_peek_band(GRect(0, band_top, FIXED_TO_INT(width), band_bottom - band_top),
+                        GRect(0, clip_top, FIXED_TO_INT(width), clip_bottom - clip_top), time_y_offset);
+// -- end jsalternative
+// -- jsalternative
+// --     draw_widget_rows(fctx, w1, w2, w3, w4, w5, w6, widgets_y, config_color_topbar_bg_local);
+    // the top bar and the space above the progress bar are all the widgets draw into
+    GRect top = GRect(0, 0, FIXED_TO_INT(width), FIXED_TO_INT(topbar_height));
+    int16_t bottom_y = FIXED_TO_INT(widgets_y - LAYOUT_WIDGETS_BOTTOM_PADDING);
+    int16_t bottom_end = FIXED_TO_INT(height_full - (progress_no ? 0 : progress_height));
+    GRect bottom = GRect(0, bottom_y, FIXED_TO_INT(width), bottom_end - bottom_y);
+    if (frozen) {
+        prerender_frozen_draw_bottom(ctx);
+    } else if (prerender_secondary_enabled()) {
+        // the secondary widgets are kept pre-rendered, so a tap only needs to copy them in (see prerender.c)
+        if (!prerender_secondary_valid(top, bottom, config_color_topbar_bg_local) && prerender_secondary_due()) {
+            draw_widget_rows(fctx, config_widget_7, config_widget_8, config_widget_9, config_widget_10, config_widget_11, config_widget_12, widgets_y, config_color_topbar_bg_local);
+            prerender_secondary_capture(ctx, top, bottom, config_color_topbar_bg_local);
+            if (!secondary) {
+                draw_rect(fctx, g2frect(top), config_color_topbar_bg_local);
+                draw_rect(fctx, g2frect(bottom), config_color_background);
+                draw_widget_rows(fctx, w1, w2, w3, w4, w5, w6, widgets_y, config_color_topbar_bg_local);
+            }
+        } else if (secondary) {
+            prerender_secondary_draw(ctx);
+        } else {
+            draw_widget_rows(fctx, w1, w2, w3, w4, w5, w6, widgets_y, config_color_topbar_bg_local);
+        }
+    } else {
+        prerender_secondary_free();
+        draw_widget_rows(fctx, w1, w2, w3, w4, w5, w6, widgets_y, config_color_topbar_bg_local);
+        if (ambient_mode) {
+            // the rain preview is frozen along with the top bar
+            GRect chart = GRect(0, 0, FIXED_TO_INT(width), FIXED_TO_INT(chart_bottom + FIXED_POINT_SCALE - 1));
+            prerender_frozen_capture(ctx, chart, bottom);
+        }
+    }
+// -- end jsalternative
 
     // draw the bluetooth popup
     bool bluetooth = bluetooth_connection_service_peek();
@@ -361,5 +458,8 @@ void background_update_proc(Layer *layer, GContext *ctx) {
 
     // end fctx
     fctx_deinit_context(fctx);
+// -- jsalternative
+    startup_frame_drawn();
+// -- end jsalternative
 }
 
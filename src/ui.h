@@ -17,7 +17,9 @@
 
 #include "graphite.h"
 
+fixed_t time_offset(fixed_t full_height, fixed_t unobstructed_height);
 void bluetooth_popup(FContext* fctx, GContext *ctx, bool connected);
+void draw_widget_rows(FContext* fctx, uint8_t w1, uint8_t w2, uint8_t w3, uint8_t w4, uint8_t w5, uint8_t w6, fixed_t bottom_y, uint8_t topbar_color);
 void background_update_proc(Layer *layer, GContext *ctx);
 bool show_weather();
 bool show_weather_impl(uint16_t timeout);
@@ -101,7 +101,7 @@ fixed_t widget_tz(FContext* fctx, bool draw, FPoint position, GTextAlignment ali
 // --     buffer_1 =
     int8_t dataidx = get_current_tz_idx(&tzinfo.data[tz_id]);
     if (dataidx == -1) return 0;
-    time_t adjusted = time(NULL) - tzinfo.data[tz_id].offsets[dataidx] * 60;
+    time_t adjusted = frame_time() - tzinfo.data[tz_id].offsets[dataidx] * 60;
     struct tm* t = gmtime(&adjusted);
     strftime(buffer_1, sizeof(buffer_1), format, t);
 // -- end jsalternative
@@ -133,7 +133,7 @@ fixed_t draw_icon_number_widget(FContext* fctx, bool draw, FPoint position, GTex
   fixed_t fontsize_icon = (fixed_t)(fontsize_widgets * 31 / 50); // 0.62
   fixed_t w1 = !show_icon ? 0 : string_width(fctx, icon, font_icon, fontsize_icon);
   fixed_t w2 = string_width(fctx, text, font_main, fontsize_widgets);
-  fixed_t sep = REM(2);
+  fixed_t sep = LAYOUT_WIDGET_SEP;
   fixed_t w = w1 + w2 + sep;
   GTextAlignment a = GTextAlignmentLeft;
   uint8_t color = foreground_color;
@@ -227,7 +227,7 @@ fixed_t drawBat(FContext *fctx, bool draw, FPoint position, GTextAlignment align
     if (align == GTextAlignmentCenter) offset = bat_width / 2;
     if (align == GTextAlignmentRight) offset = bat_width;
     FPoint bat_origin = FPoint(FIXED_ROUND(position.x - offset), FIXED_ROUND(
-            position.y + (REM(21) - bat_height) / 2));
+            position.y + (LAYOUT_BAT_CENTER - bat_height) / 2));
     // outer rect
     draw_rect(fctx, FRect(bat_origin, FSize(bat_width, bat_height)), foreground_color);
     // inner background rect
@@ -253,7 +253,14 @@ fixed_t widget_battery_icon(FContext* fctx, bool draw, FPoint position, GTextAli
 }
 
 bool showPhoneBattery() {
-    bool battery_is_outdated = (time(NULL) - phonebat.timestamp) > (config_phone_battery_expiration * 60);
+    time_t last_contact = phonebat.timestamp;
+    time_t expiration = config_phone_battery_expiration * 60;
+    // in push mode, the phone re-sends the level well within the expiration (see subscribeBattery in index.js), so a
+    // level that was still current when the connection was lost only expires relative to that
+    if (config_phone_battery_push && phonebat_disconnected > last_contact && phonebat_disconnected - last_contact <= expiration) {
+        last_contact = phonebat_disconnected;
+    }
+    bool battery_is_outdated = (frame_time() - last_contact) > expiration;
     bool invalid_bat_level = phonebat.level > 100;
     return !battery_is_outdated && !invalid_bat_level;
 }
@@ -323,8 +330,8 @@ fixed_t widget_both_battery_flipped_icon(FContext* fctx, bool draw, FPoint posit
 
 fixed_t widget_bluetooth_disconly(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
   if (!bluetooth_connection_service_peek()) {
-    fixed_t fontsize_bt_icon = REM(25);
-    if (draw) draw_string(fctx, "H", FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+    fixed_t fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
+    if (draw) draw_string(fctx, "H", FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
     return string_width(fctx, "H", font_icon, fontsize_widgets);
   }
   return 0;
@@ -332,44 +339,44 @@ fixed_t widget_bluetooth_disconly(FContext* fctx, bool draw, FPoint position, GT
 
 fixed_t widget_bluetooth_disconly_alt(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
   if (!bluetooth_connection_service_peek()) {
-    fixed_t fontsize_bt_icon = REM(25);
-    if (draw) draw_string(fctx, "I", FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+    fixed_t fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
+    if (draw) draw_string(fctx, "I", FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
     return string_width(fctx, "I", font_icon, fontsize_widgets);
   }
   return 0;
 }
 
 fixed_t widget_bluetooth_yesno(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
-  fixed_t fontsize_bt_icon = REM(25);
+  fixed_t fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
   char* icon = "DH";
   if (!bluetooth_connection_service_peek()) {
     icon = "BH";
   }
-  if (draw) draw_string(fctx, icon, FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+  if (draw) draw_string(fctx, icon, FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
   return string_width(fctx, icon, font_icon, fontsize_bt_icon);
 }
 
 fixed_t widget_quiet_offonly(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
   if (quiet_time_is_active()) {
-    fixed_t fontsize_bt_icon = REM(25);
-    if (draw) draw_string(fctx, "F", FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+    fixed_t fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
+    if (draw) draw_string(fctx, "F", FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
     return string_width(fctx, "F", font_icon, fontsize_bt_icon);
   }
   return 0;
 }
 
 fixed_t widget_quiet(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
-  fixed_t fontsize_bt_icon = REM(25);
+  fixed_t fontsize_bt_icon = LAYOUT_STATUS_ICON_FONTSIZE;
   char* icon = "G";
   if (quiet_time_is_active()) {
     icon = "F";
   }
-  if (draw) draw_string(fctx, icon, FPoint(position.x, position.y + REM(11)), font_icon, foreground_color, fontsize_bt_icon, align);
+  if (draw) draw_string(fctx, icon, FPoint(position.x, position.y + LAYOUT_STATUS_ICON_Y), font_icon, foreground_color, fontsize_bt_icon, align);
   return string_width(fctx, icon, font_icon, fontsize_bt_icon);
 }
 
 fixed_t widget_ampm(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
-  time_t now = time(NULL);
+  time_t now = frame_time();
     struct tm *t = localtime(&now);
   strftime(buffer_1, sizeof(buffer_1), "%p", t);
   if (draw) draw_string(fctx, buffer_1, position, font_main, foreground_color, fontsize_widgets, align);
@@ -377,7 +384,7 @@ fixed_t widget_ampm(FContext* fctx, bool draw, FPoint position, GTextAlignment a
 }
 
 fixed_t widget_ampm_lower(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
-  time_t now = time(NULL);
+  time_t now = frame_time();
     struct tm *t = localtime(&now);
   strftime(buffer_1, sizeof(buffer_1), "%P", t);
   if (draw) draw_string(fctx, buffer_1, position, font_main, foreground_color, fontsize_widgets, align);
@@ -385,7 +392,7 @@ fixed_t widget_ampm_lower(FContext* fctx, bool draw, FPoint position, GTextAlign
 }
 
 fixed_t widget_seconds(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
-  time_t now = time(NULL);
+  time_t now = frame_time();
     struct tm *t = localtime(&now);
   strftime(buffer_1, sizeof(buffer_1), "%S", t);
 // -- jsalternative
@@ -397,7 +404,7 @@ fixed_t widget_seconds(FContext* fctx, bool draw, FPoint position, GTextAlignmen
 }
 
 fixed_t widget_day_of_week(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color) {
-  time_t now = time(NULL);
+  time_t now = frame_time();
   struct tm *t = localtime(&now);
   strftime(buffer_1, sizeof(buffer_1), "%a", t);
   if (draw) draw_string(fctx, buffer_1, position, font_main, foreground_color, fontsize_widgets, align);
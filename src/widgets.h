@@ -75,5 +75,6 @@ fixed_t widget_calories_all_short_icon(FContext* fctx, bool draw, FPoint positio
 fixed_t widget_calories_all_short(FContext* fctx, bool draw, FPoint position, GTextAlignment align, uint8_t foreground_color, uint8_t background_color);
 // -- end autogen
 
+bool showPhoneBattery();
 
 #endif //GRAPHITE_WIDGETS_H